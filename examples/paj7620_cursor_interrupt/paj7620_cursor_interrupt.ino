@@ -0,0 +1,81 @@
+/*
+  Example Script: paj7620_cursor_interrupt.ino
+  Package: RevEng_PAJ7620
+
+  Description: This example runs "cursor mode" from the sensor's INT pin.
+    The sensor raises INT when an object comes into view and when it
+    leaves. Cursor coordinates are only read while an object is in view,
+    so there is no I2C traffic at all while nothing is in front of it.
+    This demo also enables the LED_BUILTIN -
+     when a cursor is in view the LED lights up.
+
+  Special wiring: sensor INT pin to microcontroller (Arduino) pin 2
+
+  License: Same as package under MIT License (MIT)
+*/
+
+// Includes sensor driver object and interface
+#include "RevEng_PAJ7620.h"
+
+#define INTERRUPT_PIN 2                     // Interrupt capable Arduino pin
+
+// Create gesture sensor driver object
+RevEng_PAJ7620 sensor = RevEng_PAJ7620();
+
+
+// ***************************************************************************
+void setup()
+{
+  pinMode(INTERRUPT_PIN, INPUT);
+  pinMode(LED_BUILTIN, OUTPUT);     // Configure LED for output
+
+  Serial.begin(115200);
+
+  if( !sensor.begin() )             // return value of 1 == success
+  {
+    Serial.print("PAJ7620 init error -- device not found -- halting");
+    while(true) {}
+  }
+
+  Serial.println("PAJ7620U2 init: OK.");
+
+  attachInterrupt(digitalPinToInterrupt(INTERRUPT_PIN), interruptRoutine, FALLING);
+  sensor.startCursorSession();      // Puts sensor into cursor mode
+
+  Serial.println("Move your hand over the sensor to see cursor coordinates.");
+}
+
+
+// ***************************************************************************
+void loop()
+{
+  int cursor_x = 0;
+  int cursor_y = 0;
+
+  switch( sensor.serviceCursorSession(cursor_x, cursor_y) )
+  {
+    case CURSOR_ENTER:
+      Serial.println("Cursor in view");
+      digitalWrite(LED_BUILTIN, HIGH);
+      // Fall through - the coordinates are valid
+    case CURSOR_MOVE:
+      Serial.println("(X,Y) (" + String(cursor_x) + "," + String(cursor_y) + ")");
+      break;
+
+    case CURSOR_EXIT:
+      Serial.println("No Cursor in view");
+      digitalWrite(LED_BUILTIN, LOW);
+      break;
+
+    case CURSOR_IDLE:
+      break;                        // Nothing in view, the sensor was not read
+  }
+
+  delay(20);
+}
+
+// Called when the interrupt pin goes low
+void interruptRoutine()
+{
+  sensor.notifyInterrupt();
+}
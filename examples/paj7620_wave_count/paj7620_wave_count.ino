@@ -10,18 +10,25 @@
     As you wave your hand in front of the sensor, it counts the quantity
     of passes you make, and the RevEng library exposes that value.
     This demo outputs that value and the wave event.
+    The sensor's counter only goes to 15, so a PAJ7620_WaveAccumulator
+    keeps a running total past that, and estimates the waves per minute.
 
   License: Same as package under MIT License (MIT)
 */
 
 // Includes enum definition of GES_* return values from readGesture()
 #include "RevEng_PAJ7620.h"
+// Running total & rate on top of the sensor's 4 bit wave counter
+#include "RevEng_PAJ7620_WaveAccumulator.h"
 
 // Create gesture sensor driver object
 RevEng_PAJ7620 sensor = RevEng_PAJ7620();
 
-// Last seen number of waves pulled from sensor
-int curr_wave_count = 0;
+// Tracks the counter's wraps from 15 back to 0
+PAJ7620_WaveAccumulator waves = PAJ7620_WaveAccumulator();
+
+// Last seen total number of waves
+uint32_t curr_wave_total = 0;
 
 
 // ******************************************************************
@@ -38,20 +45,21 @@ void setup()
   }
 
   Serial.println("PAJ7620U2 init: OK.");
-  Serial.println("Wave your hand to get a wave count (max 15).");
+  Serial.println("Wave your hand to get a wave count.");
 }
 
 
 // ******************************************************************
 void loop()
 {
-  int new_wave_count = 0;
-  new_wave_count = sensor.getWaveCount();     // Query for new wave count
+  uint32_t new_wave_total = waves.update(sensor);   // Reads sensor's wave count
 
-  if( new_wave_count != curr_wave_count ) {   // Only print if a new value happens
-    curr_wave_count = new_wave_count;
+  if( new_wave_total != curr_wave_total ) {   // Only print if a new value happens
+    curr_wave_total = new_wave_total;
     Serial.print("New wave count: ");
-    Serial.println(curr_wave_count);
+    Serial.print(curr_wave_total);
+    Serial.print("  waves/min: ");
+    Serial.println(waves.wavesPerMinute());
   }
 
   // Gesture is an enumerated type defined in RevEng_PAJ7620.h
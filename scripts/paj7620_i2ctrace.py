@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""PAJ7620 I2C Trace
+Decodes the binary I2C trace printed by PAJ7620_I2CTrace::print() and turns it
+into replay fixtures
+
+Record format (all records back to back):
+  - byte 0 : bit 7 set for a read, bits [6:0] data length
+  - byte 1 : register address
+  - varint : microseconds since the previous record (7 bits per byte, LSB first)
+  - data   : bytes written, or bytes the sensor returned for a read
+
+  - decode    # Print every transaction with its timestamp and register bank
+  - fixture   # Write a C header holding the trace for PAJ7620_I2CTrace::beginReplay()
+"""
+
+import re
+
+from typing import Iterable, List, NamedTuple
+
+import click
+
+
+BEGIN_MARKER = "PAJ7620 I2C TRACE BEGIN"
+END_MARKER = "PAJ7620 I2C TRACE END"
+BANK_SELECT = 0xEF
+READ_FLAG = 0x80
+LENGTH_MASK = 0x7F
+
+
+class Transaction(NamedTuple):
+    """One recorded register transaction"""
+    time_us: int
+    is_read: bool
+    bank: int
+    address: int
+    data: bytes
+
+
+def parse_capture(lines: Iterable[str]) -> bytes:
+    """parse_capture
+    Extracts the raw trace bytes from the first BEGIN/END block of a capture
+
+    inputs:
+        lines (Iterable[str]): Text lines as printed by the driver, other traffic is ignored
+
+    outputs:
+        bytes: The binary trace
+    """
+    raw = bytearray()
+    in_trace = False
+    for line in lines:
+        line = line.strip()
+        if line == BEGIN_MARKER:
+            in_trace = True
+            raw = bytearray()
+        elif line == END_MARKER and in_trace:
+            break
+        elif in_trace and re.fullmatch(r'(?:[0-9A-Fa-f]{2})+', line):
+            raw.extend(bytes.fromhex(line))
+    return bytes(raw)
+
+
+def decode_trace(raw: bytes) -> List[Transaction]:
+    """decode_trace
+    Splits a binary trace into transactions, tracking bank selects along the way
+
+    inputs:
+        raw (bytes): The binary trace
+
+    outputs:
+        List[Transaction]: Transactions in recorded order, time relative to the first one
+    """
+    transactions = []
+    position = 0
+    time_us = 0
+    bank = 0
+    while position + 2 <= len(raw):
+        header, address = raw[position], raw[position + 1]
+        position += 2
+        delta, shift = 0, 0
+        while position < len(raw):
+            byte = raw[position]
+            position += 1
+            delta |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        time_us += delta
+        count = header & LENGTH_MASK
+        data = raw[position:position + count]
+        position += count
+
+        is_read = bool(header & READ_FLAG)
+        if not is_read and address == BANK_SELECT and data:
+            bank = data[0]
+        transactions.append(Transaction(time_us, is_read, bank, address, data))
+    return transactions
+
+
+@click.group()
+def cmd():
+    """Decode PAJ7620 I2C traces and make replay fixtures
+    """
+
+
+@cmd.command()
+@click.argument("capture_file", type=click.File('r'))
+def decode(capture_file):
+    """Print the transactions in CAPTURE_FILE
+    """
+    for transaction in decode_trace(parse_capture(capture_file)):
+        print("{:>12.3f} ms  {}  B{} {:02X}: {}".format(
+            transaction.time_us / 1000.0, "R" if transaction.is_read else "W",
+            transaction.bank, transaction.address, transaction.data.hex(' ').upper()))
+
+
+@cmd.command()
+@click.argument("capture_file", type=click.File('r'))
+@click.argument("header_file", type=click.File('w'))
+@click.option("--name", default="paj7620Trace", help="Name of the generated array")
+def fixture(capture_file, header_file, name):
+    """Write the trace in CAPTURE_FILE as a C array to HEADER_FILE
+    """
+    raw = parse_capture(capture_file)
+    header_file.write("// Generated by paj7620_i2ctrace.py - {} transactions\n".format(
+        len(decode_trace(raw))))
+    header_file.write("const uint8_t {}[] = {{\n".format(name))
+    for start in range(0, len(raw), 16):
+        header_file.write("  " + ", ".join("0x{:02X}".format(b) for b in raw[start:start + 16]) + ",\n")
+    header_file.write("};\n")
+
+
+if __name__ == "__main__":
+    cmd()  # pylint: disable=E1120
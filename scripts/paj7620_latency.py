@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""PAJ7620 Gesture Latency
+Summarizes the gesture trace printed by RevEng_PAJ7620::printGestureTrace()
+
+Each traced gesture has micros() timestamps for the INT edge (0 when the INT pin
+is not wired to notifyInterrupt()), the flag read, the forward/backward check
+(0 when not run) and the return from readGesture(). This script reports
+percentiles for the time spent in each stage so setGestureEntryTime() and
+setGestureExitTime() can be tuned from data.
+
+Capture a trace with any serial monitor, for example:
+    ./serial_mon.py > trace.txt
+then run:
+    ./paj7620_latency.py trace.txt
+"""
+
+import csv
+
+from typing import Dict, Iterable, List
+
+import click
+
+
+BEGIN_MARKER = "PAJ7620 TRACE BEGIN"
+END_MARKER = "PAJ7620 TRACE END"
+
+GESTURE_NAMES = ["NONE", "UP", "DOWN", "LEFT", "RIGHT", "FORWARD", "BACKWARD",
+                 "CLOCKWISE", "ANTICLOCKWISE", "WAVE"]
+
+# (name, start column, end column) - stages are skipped when a time is 0
+STAGES = [("int->flag", "interrupt_us", "flag_us"),
+          ("flag->check", "flag_us", "check_us"),
+          ("check->return", "check_us", "return_us"),
+          ("flag->return", "flag_us", "return_us"),
+          ("int->return", "interrupt_us", "return_us")]
+
+PERCENTILES = [50, 90, 99]
+
+
+def parse_trace(lines: Iterable[str]) -> List[Dict[str, int]]:
+    """parse_trace
+    Decodes every trace block found in the captured text
+
+    inputs:
+        lines (Iterable[str]): Text lines as printed by the driver, other traffic is ignored
+
+    outputs:
+        List[Dict[str, int]]: One dict per traced gesture keyed by the CSV header
+    """
+    entries = []
+    block = None
+    for line in lines:
+        line = line.strip()
+        if line == BEGIN_MARKER:
+            block = []
+        elif line == END_MARKER and block is not None:
+            entries.extend({key: int(value) for key, value in row.items()}
+                           for row in csv.DictReader(block))
+            block = None
+        elif block is not None:
+            block.append(line)
+    return entries
+
+
+def percentile(values: List[int], pct: int) -> int:
+    """percentile
+    Nearest-rank percentile
+
+    inputs:
+        values (List[int]): Samples, need not be sorted
+        pct (int): Percentile in 0..100
+
+    outputs:
+        int: The sample at the requested rank
+    """
+    ordered = sorted(values)
+    rank = max(0, -(-pct * len(ordered) // 100) - 1)
+    return ordered[rank]
+
+
+def stage_durations(entries: List[Dict[str, int]]) -> Dict[str, List[int]]:
+    """stage_durations
+    Computes the time spent in each stage for every entry that reached it
+
+    inputs:
+        entries (List[Dict[str, int]]): Output of parse_trace()
+
+    outputs:
+        Dict[str, List[int]]: Stage name -> durations in microseconds
+    """
+    durations = {name: [] for name, _, _ in STAGES}
+    for entry in entries:
+        for name, start, end in STAGES:
+            if entry[start] and entry[end]:
+                # Unsigned 32 bit subtraction keeps micros() rollover harmless
+                durations[name].append((entry[end] - entry[start]) & 0xFFFFFFFF)
+    return durations
+
+
+@click.command()
+@click.argument("trace_file", type=click.File('r'))
+def cmd(trace_file):
+    """Print per stage latency percentiles for the trace in TRACE_FILE
+    """
+    entries = parse_trace(trace_file)
+    if not entries:
+        print("No trace entries found")
+        return
+
+    counts = {}
+    for entry in entries:
+        name = GESTURE_NAMES[entry["gesture"]] if entry["gesture"] < len(GESTURE_NAMES) else "?"
+        counts[name] = counts.get(name, 0) + 1
+    print("{} gestures: {}".format(len(entries),
+                                   ", ".join("{} {}".format(k, v) for k, v in sorted(counts.items()))))
+
+    print("{:<14}{:>6}".format("stage (ms)", "n") +
+          "".join("{:>9}".format("p{}".format(p)) for p in PERCENTILES) + "{:>9}".format("max"))
+    for name, values in stage_durations(entries).items():
+        if not values:
+            continue
+        row = [percentile(values, p) for p in PERCENTILES] + [max(values)]
+        print("{:<14}{:>6}".format(name, len(values)) +
+              "".join("{:>9.1f}".format(v / 1000.0) for v in row))
+
+
+if __name__ == "__main__":
+    cmd()  # pylint: disable=E1120
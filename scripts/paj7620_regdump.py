@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""PAJ7620 Register Dump
+Captures and compares the register dumps printed by RevEng_PAJ7620::printSnapshot()
+and RevEng_PAJ7620::printRegisters()
+
+Dump format (one line per register run, all values two digit hex):
+
+    PAJ7620 REGS BEGIN
+    B0 32: 29 01 00 01 00 03 1B 03 1B
+    B1 65: 96 00 97 01 CD 01 B0 04 2C 01
+    PAJ7620 REGS END
+
+  - capture   # Read a dump from a serial port and save it to a file
+  - diff      # Show every register that differs between two saved dumps
+"""
+
+import re
+import sys
+
+from typing import Dict, Iterable, Tuple
+
+import click
+
+
+BEGIN_MARKER = "PAJ7620 REGS BEGIN"
+END_MARKER = "PAJ7620 REGS END"
+LINE_PATTERN = re.compile(r'^B([01]) ([0-9A-Fa-f]{2}):((?: [0-9A-Fa-f]{2})*)$')
+
+RegisterMap = Dict[Tuple[int, int], int]
+
+
+def parse_dump(lines: Iterable[str]) -> RegisterMap:
+    """parse_dump
+    Decodes the register lines between the first BEGIN/END marker pair
+
+    inputs:
+        lines (Iterable[str]): Text lines as printed by the driver, other traffic is ignored
+
+    outputs:
+        RegisterMap: (bank, address) -> value for every register in the dump
+    """
+    registers = {}
+    in_dump = False
+    for line in lines:
+        line = line.strip()
+        if line == BEGIN_MARKER:
+            in_dump = True
+            registers = {}
+        elif line == END_MARKER and in_dump:
+            return registers
+        elif in_dump:
+            match = LINE_PATTERN.match(line)
+            if not match:
+                continue
+            bank = int(match[1])
+            address = int(match[2], 16)
+            for offset, value in enumerate(match[3].split()):
+                registers[(bank, address + offset)] = int(value, 16)
+    return registers
+
+
+def diff_dumps(first: RegisterMap, second: RegisterMap) -> Iterable[Tuple[int, int, int, int]]:
+    """diff_dumps
+    Compares two decoded dumps
+
+    inputs:
+        first (RegisterMap): Reference dump
+        second (RegisterMap): Dump to compare against the reference
+
+    outputs:
+        Iterable[Tuple[int, int, int, int]]: (bank, address, first value, second value)
+            for every register that differs, None when a register is missing from a dump
+    """
+    for key in sorted(set(first) | set(second)):
+        if first.get(key) != second.get(key):
+            yield key[0], key[1], first.get(key), second.get(key)
+
+
+@click.group()
+def cmd():
+    """Capture and compare PAJ7620 register dumps
+    """
+
+
+@cmd.command()
+@click.option("--port", default="/dev/ttyUSB0", help="Serial port the board is connected to")
+@click.option("--baud", default=115200, help="Serial baud rate")
+@click.argument("output", type=click.Path())
+def capture(port, baud, output):
+    """Wait for one register dump on the serial port and save it to OUTPUT
+    """
+    import serial  # pylint: disable=C0415
+
+    with serial.Serial(port, baud) as ser, open(output, 'w') as out_file:
+        in_dump = False
+        while True:
+            line = ser.readline().decode('utf-8', errors='replace').rstrip()
+            if line == BEGIN_MARKER:
+                in_dump = True
+            if in_dump:
+                out_file.write(line + '\n')
+            if line == END_MARKER and in_dump:
+                break
+    print("Saved dump to {}".format(output))
+
+
+@cmd.command()
+@click.argument("first", type=click.Path(exists=True))
+@click.argument("second", type=click.Path(exists=True))
+def diff(first, second):
+    """Print every register that differs between dumps FIRST and SECOND
+    """
+    with open(first, 'r') as first_file, open(second, 'r') as second_file:
+        first_regs = parse_dump(first_file)
+        second_regs = parse_dump(second_file)
+
+    differences = list(diff_dumps(first_regs, second_regs))
+    for bank, address, first_value, second_value in differences:
+        print("B{} {:02X}: {} -> {}".format(
+            bank, address,
+            "--" if first_value is None else "{:02X}".format(first_value),
+            "--" if second_value is None else "{:02X}".format(second_value)))
+
+    print("{} register(s) differ".format(len(differences)))
+    sys.exit(1 if differences else 0)
+
+
+if __name__ == "__main__":
+    cmd()  # pylint: disable=E1120
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""PAJ7620 Stream
+Decodes the binary frames written by PAJ7620_Stream (RevEng_PAJ7620_Stream.h)
+
+Frame layout:
+  - sync     : 0xA5
+  - type     : 0x01 cursor key frame, 0x02 cursor delta, 0x03 no object, 0x04 gesture
+  - sequence : rolling 8 bit frame counter
+  - payload  : key frame X/Y as little endian uint16, delta as int8 dX/dY,
+               gesture as one byte, nothing for no object
+  - checksum : CRC-8 (polynomial 0x07, init 0x00) over type, sequence and payload
+
+  - monitor   # Print decoded cursor samples and gestures from a serial port
+"""
+
+from typing import List, NamedTuple, Optional
+
+import click
+
+
+SYNC = 0xA5
+FRAME_CURSOR_KEY = 0x01
+FRAME_CURSOR_DELTA = 0x02
+FRAME_NO_OBJECT = 0x03
+FRAME_GESTURE = 0x04
+
+PAYLOAD_SIZES = {FRAME_CURSOR_KEY: 4, FRAME_CURSOR_DELTA: 2, FRAME_NO_OBJECT: 0, FRAME_GESTURE: 1}
+
+GESTURE_NAMES = ["NONE", "UP", "DOWN", "LEFT", "RIGHT", "FORWARD", "BACKWARD",
+                 "CLOCKWISE", "ANTICLOCKWISE", "WAVE"]
+
+
+class Event(NamedTuple):
+    """One decoded frame"""
+    kind: str                       # "cursor", "no_object" or "gesture"
+    sequence: int
+    x: Optional[int] = None
+    y: Optional[int] = None
+    gesture: Optional[int] = None
+
+
+def crc8(data: bytes) -> int:
+    """crc8
+    CRC-8 with polynomial 0x07 and init 0x00, same as PAJ7620_Stream::crc8()
+
+    inputs:
+        data (bytes): Bytes to checksum
+
+    outputs:
+        int: The CRC
+    """
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def encode_frame(frame_type: int, sequence: int, payload: bytes = b"") -> bytes:
+    """encode_frame
+    Builds a frame exactly as PAJ7620_Stream writes it - used by tests and simulators
+
+    inputs:
+        frame_type (int): One of the FRAME_* values
+        sequence (int): Frame sequence number (0..255)
+        payload (bytes): Payload for the frame type
+
+    outputs:
+        bytes: The complete frame
+    """
+    body = bytes([frame_type, sequence & 0xFF]) + payload
+    return bytes([SYNC]) + body + bytes([crc8(body)])
+
+
+class StreamDecoder:
+    """Incremental frame decoder
+
+    Feed it whatever bytes arrive from the port. It resynchronizes on the sync byte
+    after corruption, counts frames lost to sequence gaps, and ignores delta frames
+    until the next key frame whenever the delta base is unknown.
+    """
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.last_sequence = None
+        self.cursor = None
+        self.dropped = 0
+        self.crc_errors = 0
+
+    def feed(self, data: bytes) -> List[Event]:
+        """feed
+        Decodes every complete frame available
+
+        inputs:
+            data (bytes): Newly received bytes
+
+        outputs:
+            List[Event]: Events decoded from complete, valid frames
+        """
+        self.buffer.extend(data)
+        events = []
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                self.buffer.clear()
+                return events
+            del self.buffer[:start]
+            if len(self.buffer) < 2:
+                return events
+
+            size = PAYLOAD_SIZES.get(self.buffer[1])
+            if size is None:
+                del self.buffer[0]      # Not a frame start after all
+                continue
+            if len(self.buffer) < 4 + size:
+                return events
+
+            frame = bytes(self.buffer[:4 + size])
+            if crc8(frame[1:-1]) != frame[-1]:
+                self.crc_errors += 1
+                del self.buffer[0]
+                continue
+            del self.buffer[:4 + size]
+
+            event = self._decode(frame[1], frame[2], frame[3:-1])
+            if event:
+                events.append(event)
+
+    def _decode(self, frame_type: int, sequence: int, payload: bytes) -> Optional[Event]:
+        if self.last_sequence is not None:
+            gap = (sequence - self.last_sequence - 1) & 0xFF
+            if gap:
+                self.dropped += gap
+                self.cursor = None      # A lost frame may have moved the cursor
+        self.last_sequence = sequence
+
+        if frame_type == FRAME_CURSOR_KEY:
+            self.cursor = (payload[0] | payload[1] << 8, payload[2] | payload[3] << 8)
+        elif frame_type == FRAME_CURSOR_DELTA:
+            if self.cursor is None:
+                return None
+            delta_x = int.from_bytes(payload[0:1], 'little', signed=True)
+            delta_y = int.from_bytes(payload[1:2], 'little', signed=True)
+            self.cursor = (self.cursor[0] + delta_x, self.cursor[1] + delta_y)
+        elif frame_type == FRAME_NO_OBJECT:
+            self.cursor = None
+            return Event("no_object", sequence)
+        else:
+            return Event("gesture", sequence, gesture=payload[0])
+        return Event("cursor", sequence, x=self.cursor[0], y=self.cursor[1])
+
+
+@click.command()
+@click.option("--port", default="/dev/ttyUSB0", help="Serial port the board is connected to")
+@click.option("--baud", default=115200, help="Serial baud rate")
+def cmd(port, baud):
+    """Print decoded frames from the serial port until interrupted
+    """
+    import serial  # pylint: disable=C0415
+
+    decoder = StreamDecoder()
+    with serial.Serial(port, baud, timeout=0.1) as ser:
+        try:
+            while True:
+                for event in decoder.feed(ser.read(ser.in_waiting or 1)):
+                    if event.kind == "cursor":
+                        print("{:3d} cursor ({},{})".format(event.sequence, event.x, event.y))
+                    elif event.kind == "gesture":
+                        name = GESTURE_NAMES[event.gesture] if event.gesture < len(GESTURE_NAMES) else "?"
+                        print("{:3d} gesture {}".format(event.sequence, name))
+                    else:
+                        print("{:3d} no object".format(event.sequence))
+        except KeyboardInterrupt:
+            print("Interrupted - dropped {} frames, {} checksum errors".format(
+                decoder.dropped, decoder.crc_errors))
+
+
+if __name__ == "__main__":
+    cmd()  # pylint: disable=E1120
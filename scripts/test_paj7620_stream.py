@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""Tests for paj7620_stream.py
+
+Run with: python3 -m unittest test_paj7620_stream  (from the scripts directory)
+"""
+
+import os
+import threading
+import time
+import tty
+import unittest
+
+import paj7620_stream as stream
+
+
+# Same golden bytes as test/test_stream.cpp
+GOLDEN = bytes([
+    0xA5, 0x01, 0x00, 0x34, 0x02, 0x56, 0x01, 0x7B,
+    0xA5, 0x02, 0x01, 0xFC, 0x0A, 0x99,
+    0xA5, 0x03, 0x02, 0x31,
+    0xA5, 0x04, 0x03, 0x09, 0xAB,
+])
+
+
+class StreamDecoderTest(unittest.TestCase):
+    """Frame decoding"""
+
+    def test_golden_frames(self):
+        """Decodes the frames the C++ writer produces"""
+        events = stream.StreamDecoder().feed(GOLDEN)
+        self.assertEqual(events, [
+            stream.Event("cursor", 0, x=0x234, y=0x156),
+            stream.Event("cursor", 1, x=0x230, y=0x160),
+            stream.Event("no_object", 2),
+            stream.Event("gesture", 3, gesture=9),
+        ])
+
+    def test_byte_at_a_time(self):
+        """Frames split across reads still decode"""
+        decoder = stream.StreamDecoder()
+        events = []
+        for byte in GOLDEN:
+            events.extend(decoder.feed(bytes([byte])))
+        self.assertEqual(len(events), 4)
+
+    def test_corruption_resyncs(self):
+        """A bad checksum drops only the damaged frame"""
+        damaged = bytearray(GOLDEN)
+        damaged[11] ^= 0xFF
+        decoder = stream.StreamDecoder()
+        events = decoder.feed(b"\x00\xA5junk" + bytes(damaged))
+        self.assertEqual(decoder.crc_errors, 1)
+        self.assertEqual([e.kind for e in events], ["cursor", "no_object", "gesture"])
+        self.assertEqual(decoder.dropped, 1)
+
+    def test_delta_after_drop_waits_for_key_frame(self):
+        """Deltas are not applied to a stale base after lost frames"""
+        frames = (stream.encode_frame(stream.FRAME_CURSOR_KEY, 0, bytes([10, 0, 10, 0])) +
+                  stream.encode_frame(stream.FRAME_CURSOR_DELTA, 2, bytes([1, 1])) +
+                  stream.encode_frame(stream.FRAME_CURSOR_KEY, 3, bytes([20, 0, 20, 0])))
+        events = stream.StreamDecoder().feed(frames)
+        self.assertEqual([(e.x, e.y) for e in events], [(10, 10), (20, 20)])
+
+
+class StreamThroughputTest(unittest.TestCase):
+    """Decoding throughput over a pty stand-in for the serial port"""
+
+    FRAMES = 20000
+
+    def test_pty_throughput(self):
+        """Every frame written to the pty is decoded, reports frames per second"""
+        master, slave = os.openpty()
+        tty.setraw(slave)
+        payload = b"".join(stream.encode_frame(stream.FRAME_CURSOR_DELTA, seq & 0xFF, bytes([1, 0xFF]))
+                           for seq in range(self.FRAMES))
+
+        def writer():
+            os.write(master, stream.encode_frame(stream.FRAME_CURSOR_KEY, 0xFF, bytes([0, 1, 0, 1])))
+            view = memoryview(payload)
+            while view:
+                view = view[os.write(master, view[:4096]):]
+
+        decoder = stream.StreamDecoder()
+        received = 0
+        thread = threading.Thread(target=writer)
+        start = time.perf_counter()
+        thread.start()
+        while received < self.FRAMES + 1:
+            received += len(decoder.feed(os.read(slave, 4096)))
+        elapsed = time.perf_counter() - start
+        thread.join()
+        os.close(master)
+        os.close(slave)
+
+        self.assertEqual(decoder.dropped, 0)
+        self.assertEqual(decoder.crc_errors, 0)
+        self.assertEqual(decoder.cursor, (256 + self.FRAMES, 256 - self.FRAMES))
+        # 6 byte frames: 115200 baud carries ~1900 frames/s, decoding must keep up easily
+        print("\n  decoded {:.0f} frames/s".format(received / elapsed))
+        self.assertGreater(received / elapsed, 1920)
+
+
+if __name__ == "__main__":
+    unittest.main()
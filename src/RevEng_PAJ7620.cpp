@@ -53,6 +53,99 @@
 */
 
 #include "RevEng_PAJ7620.h"
+#include "RevEng_PAJ7620_AdaptiveTiming.h"
+
+
+/**
+ * PAJ7620 driver object constructor
+ * \note No I2C traffic happens until begin() is called
+ */
+RevEng_PAJ7620::RevEng_PAJ7620()
+{
+  gestureEntryTime = 0;
+  gestureExitTime = 200;
+  wireHandle = NULL;
+  busClock = 0;
+  cursorModeActive = false;
+
+  // Same values as setCursorModeRegisterArray
+  cursorConfig.positionFilterStart = 0x001;
+  cursorConfig.processFilterStart = 0x001;
+  cursorConfig.clampLeft = 0x03;
+  cursorConfig.clampRight = 0x1B;
+  cursorConfig.clampUp = 0x03;
+  cursorConfig.clampDown = 0x1B;
+  cursorConfig.objectSizeThreshold = 0x01;
+  cursorConfig.positionResolution = 0x07;
+  memset(cursorRegisters, 0, sizeof(cursorRegisters));
+  cursorRegistersKnown = false;
+
+  memset(&lastSnapshot, 0, sizeof(lastSnapshot));
+  snapshotReads = false;
+
+  memset(&psCalibration, 0, sizeof(psCalibration));
+  sensorDisabled = false;
+
+  selectedBank = PAJ7620_BANK0;
+  canaryValue = PAJ7620_HEALTH_CANARY_RESET;
+  healthInterval = 0;
+  lastHealthCheck = 0;
+  memset(&healthStats, 0, sizeof(healthStats));
+
+  lensRegister = 0x00;
+  lensFlip = 0x00;
+  quarterTurns = 0;
+  mirrorX = false;
+
+  interruptTime = 0;
+  interruptPending = false;
+  cursorSession = false;
+  cursorPresent = false;
+  traceBuffer = NULL;
+  traceDepth = 0;
+  traceHead = 0;
+  traceCount = 0;
+
+  lockHandle = NULL;
+  clockHandle = &PAJ7620_ArduinoClock::shared;
+
+  uploadArray = NULL;
+  uploadSize = 0;
+  uploadIndex = 0;
+  uploadBank = PAJ7620_BANK0;
+
+  i2cTrace = NULL;
+  adaptiveTiming = NULL;
+  burstUploads = PAJ7620_BURST_VERIFY;
+  burstVerified = false;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  taskLock = NULL;
+  sensorTask = NULL;
+  gestureQueue = NULL;
+  sensorTaskPeriod = 0;
+  sensorTaskStop = false;
+#endif
+}
+
+
+/**
+ * PAJ7620 driver object destructor
+ * \note Stops the sensor task and frees the lock and queue it created
+ */
+RevEng_PAJ7620::~RevEng_PAJ7620()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  stopSensorTask();
+  if (lockHandle == taskLock)
+    { lockHandle = NULL; }
+  delete taskLock;
+  taskLock = NULL;
+  if (gestureQueue)
+    { vQueueDelete(gestureQueue); }
+  gestureQueue = NULL;
+#endif
+}
 
 
 /**
@@ -81,6 +174,28 @@ uint8_t RevEng_PAJ7620::begin()
  */
 uint8_t RevEng_PAJ7620::begin(TwoWire *chosenWireHandle)
 {
+  return begin(chosenWireHandle, PAJ7620_I2C_CLOCK_KEEP);
+}
+
+/**
+ * PAJ7620 device initialization on specified Wire bus at a chosen bus clock
+ *
+ * Override version:
+ * \par
+ * Sets the I2C clock before the register tables are written, so begin()
+ * itself already runs at that speed. The PAJ7620 handles up to 400kHz.
+ * With #PAJ7620_I2C_CLOCK_PROBE the fastest speed that passes
+ * probeBusSpeed() is used - read it back with getBusClock().
+ * \note The clock applies to the whole bus, other devices on it must cope
+ * \param chosenWireHandle A pointer to the Wire handle that should be
+ *   used to communicate with the PAJ7620
+ * \param busClockHz : clock in Hz (Ex: 400000), #PAJ7620_I2C_CLOCK_KEEP
+ *   or #PAJ7620_I2C_CLOCK_PROBE
+ * \return error code: 0 (false); success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::begin(TwoWire *chosenWireHandle, uint32_t busClockHz)
+{
+  PAJ7620_LockGuard guard(lockHandle);
   // Reasonable timing delay values to make algorithm insensitive to
   //  hand entry and exit moves before and after detecting a gesture
   gestureEntryTime = 0;
@@ -88,15 +203,22 @@ uint8_t RevEng_PAJ7620::begin(TwoWire *chosenWireHandle)
 
   wireHandle = chosenWireHandle;      // Save selected I2C bus for our use
 
-  delayMicroseconds(700);	            // Wait 700us for PAJ7620U2 to stabilize
+  clockHandle->sleepMicros(700);      // Wait 700us for PAJ7620U2 to stabilize
                                       // Reason: see v0.8 of 7620 documentation
   wireHandle->begin();
+  if (busClockHz == PAJ7620_I2C_CLOCK_PROBE)
+    { setBusClock(PAJ7620_I2C_CLOCK_MIN); }   // Find the device at a safe speed first
+  else if (busClockHz != PAJ7620_I2C_CLOCK_KEEP)
+    { setBusClock(busClockHz); }
   selectRegisterBank(BANK0);          // Default operations on BANK0
 
   if( !isPAJ7620UDevice() ) {
     return 0;                         // Return false - wrong device found
   }
 
+  if (busClockHz == PAJ7620_I2C_CLOCK_PROBE && !probeBusSpeed())
+    { return 0; }
+
   initializeDeviceSettings();         // Set registers up
   setGestureMode();                   // Specifically set to gesture mode
 
@@ -104,6 +226,115 @@ uint8_t RevEng_PAJ7620::begin(TwoWire *chosenWireHandle)
 }
 
 
+/**
+ * Finds the fastest bus clock the wiring to this sensor handles reliably
+ *
+ * \par
+ * Steps up from #PAJ7620_I2C_CLOCK_MIN to #PAJ7620_I2C_CLOCK_MAX. At each
+ * speed the part ID is burst read and a scratch register is written and read
+ * back with alternating bit patterns, rounds times. Stepping stops at the
+ * first failure and the bus is set marginSteps below the fastest passing
+ * speed, to leave room for temperature and noise. If every speed passes
+ * the maximum is used.
+ * \note Log the result per unit - long cables vary between installations.
+ *   The scratch register (#PAJ7620_ADDR_PROBE_SCRATCH) is the health canary,
+ *   restored after. If that restore fails the next health check sees the
+ *   mismatch and re-initializes the sensor.
+ * \param rounds : round trips each speed must pass
+ * \param marginSteps : #PAJ7620_I2C_CLOCK_STEP steps to back off after a failure
+ * \return uint32_t : bus clock chosen in Hz, 0 if even the slowest speed failed
+ *   (the bus is then left at #PAJ7620_I2C_CLOCK_MIN) or begin() was not called
+ */
+uint32_t RevEng_PAJ7620::probeBusSpeed(uint8_t rounds, uint8_t marginSteps)
+{
+  if (!wireHandle)
+    { return 0; }                   // No bus before begin()
+
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t scratch = canaryValue;    // Tracked by noteWrite(), no read needed
+  uint32_t fastest = 0;
+  bool failed = false;
+
+  for (uint32_t hz = PAJ7620_I2C_CLOCK_MIN; hz <= PAJ7620_I2C_CLOCK_MAX;
+       hz += PAJ7620_I2C_CLOCK_STEP)
+  {
+    setBusClock(hz);
+    if (busRoundTrips(rounds))
+    {
+      failed = true;
+      break;
+    }
+    fastest = hz;
+  }
+
+  uint32_t chosen = fastest;
+  if (failed)
+  {
+    uint32_t margin = (uint32_t)marginSteps * PAJ7620_I2C_CLOCK_STEP;
+    chosen = (fastest >= PAJ7620_I2C_CLOCK_MIN + margin) ? fastest - margin
+                                                         : PAJ7620_I2C_CLOCK_MIN;
+  }
+  setBusClock(chosen ? chosen : PAJ7620_I2C_CLOCK_MIN);
+
+  // A failed round may have left the scratch value or the bank behind
+  selectRegisterBank(BANK0);
+  writeRegister(PAJ7620_ADDR_PROBE_SCRATCH, scratch);
+  canaryValue = scratch;            // Even if that failed: the health check catches it
+  return fastest ? chosen : 0;
+}
+
+
+/**
+ * Returns the bus clock set by begin() or probeBusSpeed()
+ * \param none
+ * \return uint32_t : clock in Hz, 0 if the driver left the Wire clock alone
+ */
+uint32_t RevEng_PAJ7620::getBusClock()
+{
+  return busClock;
+}
+
+
+/**
+ * Sets the Wire clock and remembers it
+ * \param hz : bus clock in Hz
+ * \return none - does nothing before begin()
+ */
+void RevEng_PAJ7620::setBusClock(uint32_t hz)
+{
+  if (!wireHandle)
+    { return; }
+  wireHandle->setClock(hz);
+  busClock = hz;
+}
+
+
+/**
+ * Checks the bus at the current clock with part-ID and scratch round trips
+ * \param rounds : quantity of round trips
+ * \return error code; success: return 0
+ */
+uint8_t RevEng_PAJ7620::busRoundTrips(uint8_t rounds)
+{
+  selectRegisterBank(BANK0);
+  for (uint8_t i = 0; i < rounds; i++)
+  {
+    uint8_t id[2] = { 0 };
+    if (readRegister(PAJ7620_ADDR_PART_ID_0, 2, id) ||
+        id[0] != PAJ7620_PART_ID_LSB || id[1] != PAJ7620_PART_ID_MSB)
+      { return 1; }
+
+    uint8_t pattern = (i & 1) ? 0xAA : 0x55;
+    uint8_t readBack = ~pattern;    // A short read can not pass
+    if (writeRegister(PAJ7620_ADDR_PROBE_SCRATCH, pattern) ||
+        readRegister(PAJ7620_ADDR_PROBE_SCRATCH, 1, &readBack) ||
+        readBack != pattern)
+      { return 1; }
+  }
+  return 0;
+}
+
+
 /**
  * Write memory register over I2C
  * \param i2cAddress register address
@@ -112,12 +343,7 @@ uint8_t RevEng_PAJ7620::begin(TwoWire *chosenWireHandle)
  */
 uint8_t RevEng_PAJ7620::writeRegister(uint8_t i2cAddress, uint8_t dataByte)
 {
-  uint8_t resultCode = 0;
-  wireHandle->beginTransmission(PAJ7620_I2C_BUS_ADDR);   // start transmission
-  wireHandle->write(i2cAddress);                         // send register address
-  wireHandle->write(dataByte);                           // send value to write
-  resultCode = wireHandle->endTransmission();            // end transmission
-  return resultCode;
+  return writeRegisters(i2cAddress, 1, &dataByte);
 }
 
 /**
@@ -129,6 +355,9 @@ uint8_t RevEng_PAJ7620::writeRegister(uint8_t i2cAddress, uint8_t dataByte)
  */
 uint8_t RevEng_PAJ7620::readRegister(uint8_t i2cAddress, uint8_t byteCount, uint8_t data[])
 {
+  if (i2cTrace && i2cTrace->isReplaying())
+    { return i2cTrace->replayTransaction(true, i2cAddress, byteCount, data) ? 0 : 4; }
+
   uint8_t result_code;
   wireHandle->beginTransmission(PAJ7620_I2C_BUS_ADDR);
   wireHandle->write(i2cAddress);
@@ -139,16 +368,108 @@ uint8_t RevEng_PAJ7620::readRegister(uint8_t i2cAddress, uint8_t byteCount, uint
 
   wireHandle->requestFrom((int)PAJ7620_I2C_BUS_ADDR, (int)byteCount);
 
+  uint8_t *first = data;
   while (wireHandle->available())
   {
     *data = wireHandle->read();
     data++;
   }
 
+  if (i2cTrace)
+    { i2cTrace->recordTransaction(true, i2cAddress, byteCount, first, clockHandle->nowMicros()); }
+
+  return 0;
+}
+
+/**
+ * Write a run of consecutive memory registers over I2C in one transaction
+ * \par
+ * The PAJ7620 auto-increments the register address after each data byte,
+ * so byteCount values land in i2cAddress, i2cAddress + 1, ...
+ * \param i2cAddress : first register address
+ * \param byteCount : quantity of bytes to write (at most #PAJ7620_I2C_BURST_MAX)
+ * \param data : array of uint8_t to write from
+ * \return error code; success: return 0
+ */
+uint8_t RevEng_PAJ7620::writeRegisters(uint8_t i2cAddress, uint8_t byteCount, const uint8_t data[])
+{
+  if (i2cTrace && i2cTrace->isReplaying())
+  {
+    if (!i2cTrace->replayTransaction(false, i2cAddress, byteCount,
+                                     const_cast<uint8_t *>(data)))
+      { return 4; }
+    noteWrite(i2cAddress, byteCount, data);
+    return 0;
+  }
+
+  uint8_t resultCode = 0;
+  wireHandle->beginTransmission(PAJ7620_I2C_BUS_ADDR);   // start transmission
+  wireHandle->write(i2cAddress);                         // send first register address
+  for (uint8_t i = 0; i < byteCount; i++)
+  {
+    wireHandle->write(data[i]);                          // send values to write
+  }
+  resultCode = wireHandle->endTransmission();            // end transmission
+
+  if (i2cTrace && resultCode == 0)
+    { i2cTrace->recordTransaction(false, i2cAddress, byteCount, data, clockHandle->nowMicros()); }
+  if (resultCode == 0)
+    { noteWrite(i2cAddress, byteCount, data); }
+
+  return resultCode;
+}
+
+
+/**
+ * Write a run of consecutive registers the way setBurstUploads() allows
+ * \par
+ * One burst, unless burst uploads are off (Ex: after a sensor failed to
+ * auto-increment), in which case every register goes out on its own.
+ * \param i2cAddress : first register address
+ * \param byteCount : quantity of bytes to write (at most #PAJ7620_I2C_BURST_MAX)
+ * \param data : array of uint8_t to write from
+ * 
+eturn error code; success: return 0
+ */
+uint8_t RevEng_PAJ7620::writeRegisterRun(uint8_t i2cAddress, uint8_t byteCount, const uint8_t data[])
+{
+  if (burstUploads != PAJ7620_BURST_OFF)
+    { return writeRegisters(i2cAddress, byteCount, data); }
+
+  for (uint8_t i = 0; i < byteCount; i++)
+  {
+    uint8_t resultCode = writeRegister(i2cAddress + i, data[i]);
+    if (resultCode)
+      { return resultCode; }
+  }
   return 0;
 }
 
 
+/**
+ * Tracks the selected bank and the health canary across all writes
+ *
+ * \par
+ * Every path that writes registers (arrays, sliced uploads, configs,
+ * restore()) goes through writeRegisters(), so the canary's expected value
+ * is always the value last written to it.
+ * \param i2cAddress : first register written
+ * \param byteCount : quantity of registers written
+ * \param data : values written
+ * \return none
+ */
+void RevEng_PAJ7620::noteWrite(uint8_t i2cAddress, uint8_t byteCount, const uint8_t data[])
+{
+  if (byteCount == 0)
+    { return; }
+  if (i2cAddress == PAJ7620_REGISTER_BANK_SEL)
+    { selectedBank = data[0]; }
+  else if (selectedBank == PAJ7620_BANK0 && i2cAddress <= PAJ7620_ADDR_HEALTH_CANARY &&
+           PAJ7620_ADDR_HEALTH_CANARY < i2cAddress + byteCount)
+    { canaryValue = data[PAJ7620_ADDR_HEALTH_CANARY - i2cAddress]; }
+}
+
+
 /**
  * Read the gestures interrupt vector #0 - all gestures except wave
  * \param data : &uint8_t for storing value read
@@ -216,6 +537,23 @@ bool RevEng_PAJ7620::isPAJ7620UDevice()
 }
 
 
+/**
+ * Reads one entry of a register table
+ * \note Expects array[] to be stored in PROGMEM if it is available on your microcontroller
+ * \param array : array of const unsigned shorts - first byte is address, second byte is data
+ * \param index : entry to read
+ * \return uint16_t : the table entry
+ */
+uint16_t RevEng_PAJ7620::readTableWord(const unsigned short array[], int index)
+{
+  #ifdef PROGMEM_COMPATIBLE
+    return pgm_read_word(&array[index]);
+  #else
+    return array[index];
+  #endif
+}
+
+
 /**
  * Writes an array of values to the device memory
  * 
@@ -225,6 +563,7 @@ bool RevEng_PAJ7620::isPAJ7620UDevice()
  * in the \link initRegisterArray \endlink from the driver's header file
  * 
  * \note Expects array[] to be stored in PROGMEM if it is available on your microcontroller
+ * \note Runs of consecutive addresses go out as single burst writes, see setBurstUploads()
  * 
  * \param array : array of const unsigned shorts - first byte is address, second byte is data
  * \param arraySize : quantity of elements in array to write
@@ -232,20 +571,156 @@ bool RevEng_PAJ7620::isPAJ7620UDevice()
  */
 void RevEng_PAJ7620::writeRegisterArray(const unsigned short array[], int arraySize)
 {
-  for (unsigned int i = 0; i < arraySize; i++)
+  int i = 0;
+  while (i < arraySize)
+    { i += writeTableRun(array, arraySize, i); }
+  selectRegisterBank(BANK0);        // Guarantee parking in BANK0
+  settleBurstUploads();
+}
+
+
+/**
+ * Writes the run of consecutive registers starting at a table entry
+ *
+ * \par
+ * Following entries are added to the run while each addresses the register
+ * after the last one, up to #PAJ7620_I2C_BURST_MAX. Bank selects always go
+ * out on their own. The tables are scanned as they are written, so they
+ * stay in their documented one-entry-per-register form.
+ * \param array : register table, same encoding as writeRegisterArray()
+ * \param arraySize : quantity of elements in array
+ * \param index : first entry to write
+ * \return int : quantity of table entries written (at least 1)
+ */
+int RevEng_PAJ7620::writeTableRun(const unsigned short array[], int arraySize, int index)
+{
+  uint8_t values[PAJ7620_I2C_BURST_MAX];
+  uint16_t word = readTableWord(array, index);
+  uint8_t address = (word & 0xFF00) >> 8;
+  uint8_t count = 1;
+  values[0] = (word & 0x00FF);
+
+  if (burstUploads != PAJ7620_BURST_OFF && address != PAJ7620_REGISTER_BANK_SEL)
   {
-    #ifdef PROGMEM_COMPATIBLE
-      uint16_t word = pgm_read_word(&array[i]);
-    #else
-      uint16_t word = array[i];
-    #endif
+    while (count < PAJ7620_I2C_BURST_MAX && index + count < arraySize)
+    {
+      word = readTableWord(array, index + count);
+      uint8_t next = (word & 0xFF00) >> 8;
+      if (next != address + count || next == PAJ7620_REGISTER_BANK_SEL)
+        { break; }
+      values[count++] = (word & 0x00FF);
+    }
+  }
 
-    uint8_t address, value;
-    address = (word & 0xFF00) >> 8;
-    value = (word & 0x00FF);
-    writeRegister(address, value);
+  if (count == 1)
+    { writeRegister(address, values[0]); }
+  else
+  {
+    writeRegisters(address, count, values);
+    if (burstUploads == PAJ7620_BURST_VERIFY)
+      { verifyTableRun(address, count, values); }
   }
-  selectRegisterBank(BANK0);        // Guarantee parking in BANK0
+  return count;
+}
+
+
+/**
+ * Reads back a burst written run, and drops to single writes if needed
+ *
+ * \par
+ * The run is read back in one burst (reads auto-increment, as poll() and
+ * snapshot() rely on) and compared as a whole. Only registers that do not
+ * hold the value written are written again on their own and read once
+ * more: if they now match, the sensor did not honor the burst and burst
+ * uploads are turned off for good. If they still differ the register
+ * simply does not read back what is written (Ex: self clearing), which is
+ * not held against bursts.
+ * \param i2cAddress : first register of the run
+ * \param byteCount : quantity of registers in the run
+ * \param values : values written
+ * \return none
+ */
+void RevEng_PAJ7620::verifyTableRun(uint8_t i2cAddress, uint8_t byteCount, const uint8_t values[])
+{
+  uint8_t readBack[PAJ7620_I2C_BURST_MAX];
+  for (uint8_t i = 0; i < byteCount; i++)
+    { readBack[i] = ~values[i]; }   // A short read can not pass
+  if (readRegister(i2cAddress, byteCount, readBack))
+    { return; }                     // Nothing learned either way
+
+  for (uint8_t i = 0; i < byteCount; i++)
+  {
+    if (readBack[i] == values[i])
+    {
+      burstVerified = true;
+      continue;
+    }
+
+    uint8_t single = ~values[i];
+    writeRegister(i2cAddress + i, values[i]);
+    readRegister(i2cAddress + i, 1, &single);
+    if (single == values[i])
+      { burstUploads = PAJ7620_BURST_OFF; }
+  }
+}
+
+
+/**
+ * Ends the verify phase once a whole table upload has been checked
+ *
+ * \par
+ * In PAJ7620_BURST_VERIFY mode, an upload without a fallback in which at
+ * least one run register read back as written proves the sensor honors
+ * bursts, so later uploads skip the read back. If nothing could be read
+ * back (Ex: bus without read support) the next upload is verified again.
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::settleBurstUploads()
+{
+  if (burstUploads == PAJ7620_BURST_VERIFY && burstVerified)
+    { burstUploads = PAJ7620_BURST_ON; }
+  burstVerified = false;
+}
+
+
+/**
+ * Chooses how register tables are uploaded
+ *
+ * \par
+ * Runs of consecutive registers in the init and mode tables can be sent as
+ * one auto-increment burst each, which needs about half the I2C transactions
+ * of one write per entry and speeds up begin() and mode changes.
+ *
+ * \par
+ * The default, PAJ7620_BURST_VERIFY, bursts and reads every run back. A
+ * register that only takes its value when written on its own switches the
+ * driver to PAJ7620_BURST_OFF for good; once a whole upload reads back
+ * clean the driver moves to PAJ7620_BURST_ON and stops reading back. After
+ * begin() getBurstUploads() normally returns one of those two.
+ * PAJ7620_BURST_ON skips the check, PAJ7620_BURST_OFF never bursts.
+ * \note Call before begin() to cover the init table upload
+ * \param mode : #PAJ7620_BURST_OFF, #PAJ7620_BURST_ON or #PAJ7620_BURST_VERIFY
+ *   (other values select #PAJ7620_BURST_VERIFY)
+ * \return none
+ */
+void RevEng_PAJ7620::setBurstUploads(uint8_t mode)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  burstUploads = (mode > PAJ7620_BURST_VERIFY) ? PAJ7620_BURST_VERIFY : mode;
+  burstVerified = false;
+}
+
+
+/**
+ * Gets the register table upload mode
+ * \param none
+ * \return uint8_t : PAJ7620_BURST_* mode in use - PAJ7620_BURST_VERIFY until an
+ *   upload has read back clean, then PAJ7620_BURST_ON, or PAJ7620_BURST_OFF after a fallback
+ */
+uint8_t RevEng_PAJ7620::getBurstUploads()
+{
+  return burstUploads;
 }
 
 
@@ -263,6 +738,8 @@ void RevEng_PAJ7620::writeRegisterArray(const unsigned short array[], int arrayS
 void RevEng_PAJ7620::initializeDeviceSettings()
 {
   writeRegisterArray(initRegisterArray, INIT_REG_ARRAY_SIZE);
+  findTableValue(initRegisterArray, INIT_REG_ARRAY_SIZE,
+                 PAJ7620_BANK1, PAJ7620_ADDR_LENS_ORIENTATION, lensRegister);
 }
 
 
@@ -277,7 +754,10 @@ void RevEng_PAJ7620::initializeDeviceSettings()
  */
 void RevEng_PAJ7620::setGestureMode()
 {
+  PAJ7620_LockGuard guard(lockHandle);
+  uploadArray = NULL;               // Supersedes any queued mode change
   writeRegisterArray(setGestureModeRegisterArray, SET_GES_MODE_REG_ARRAY_SIZE);
+  modeChanged(false);
 }
 
 
@@ -292,132 +772,675 @@ void RevEng_PAJ7620::setGestureMode()
  */
 void RevEng_PAJ7620::setCursorMode()
 {
+  PAJ7620_LockGuard guard(lockHandle);
+  uploadArray = NULL;               // Supersedes any queued mode change
   writeRegisterArray(setCursorModeRegisterArray, SET_CURSOR_MODE_REG_ARRAY_SIZE);
+  modeChanged(true);
 }
 
 
 /**
- * Gets cursor object's current X location
- * 
- * \note Only works in cursor mode
+ * Queues a switch to Gesture mode without blocking the bus
+ *
+ * \par
+ * The gesture mode register array is written a few entries at a time by
+ * serviceBus() so other devices on a shared I2C bus are not starved while
+ * the whole table goes out. Use isBusWorkPending() to see when it is done.
  * \param none
- * \return int : X coordinate of cursor
+ * \return none
  */
-int RevEng_PAJ7620::getCursorX()
+void RevEng_PAJ7620::requestGestureMode()
 {
-  int result = 0;
-  uint8_t data0 = 0x00;
-  uint8_t data1 = 0x00;
+  PAJ7620_LockGuard guard(lockHandle);
+  uploadArray = setGestureModeRegisterArray;
+  uploadSize = SET_GES_MODE_REG_ARRAY_SIZE;
+  uploadIndex = 0;
+  uploadBank = PAJ7620_BANK0;
+}
 
-  readRegister(PAJ7620_ADDR_CURSOR_X_LOW, 1, &data0);
-  readRegister(PAJ7620_ADDR_CURSOR_X_HIGH, 1, &data1);
-  data1 &= 0x0F;      // Mask off high bits (unused)
-  result |= data1;
-  result = result << 8;
-  result |= data0;
 
-  return result;
+/**
+ * Queues a switch to Cursor mode without blocking the bus
+ * \see requestGestureMode()
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::requestCursorMode()
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  uploadArray = setCursorModeRegisterArray;
+  uploadSize = SET_CURSOR_MODE_REG_ARRAY_SIZE;
+  uploadIndex = 0;
+  uploadBank = PAJ7620_BANK0;
 }
 
 
 /**
- * Gets cursor object's current Y location
- * 
- * \note Only works in cursor mode
- * \param none
- * \return int : Y coordinate of cursor
+ * Writes part of a queued mode change, staying within a time budget
+ *
+ * \par
+ * At least one register, or run of consecutive registers, is written per call
+ * so the upload always progresses.
+ * Between calls the sensor is parked in bank 0, so other driver calls stay
+ * valid while a table is half written; the next slice reselects its bank.
+ * \param budgetUs : microseconds this slice may use the bus for
+ * \return bool : True if more of the table remains to be written
  */
-int RevEng_PAJ7620::getCursorY()
+bool RevEng_PAJ7620::serviceBus(unsigned long budgetUs)
 {
-  int result = 0;
-  uint8_t data0 = 0x00;
-  uint8_t data1 = 0x00;
+  PAJ7620_LockGuard guard(lockHandle);
+  if (!uploadArray)
+    { return false; }
 
-  readRegister(PAJ7620_ADDR_CURSOR_Y_LOW, 1, &data0);
-  readRegister(PAJ7620_ADDR_CURSOR_Y_HIGH, 1, &data1);
-  data1 &= 0x0F;      // Mask off high bits (unused)
-  result |= data1;
-  result = result << 8;
-  result |= data0;
+  unsigned long start = clockHandle->nowMicros();
+  if (uploadBank != PAJ7620_BANK0)
+    { writeRegister(PAJ7620_REGISTER_BANK_SEL, uploadBank); }
 
-  return result;
+  do
+  {
+    uint16_t word = readTableWord(uploadArray, uploadIndex);
+    if (((word & 0xFF00) >> 8) == PAJ7620_REGISTER_BANK_SEL)
+      { uploadBank = (word & 0x00FF); }
+    uploadIndex += writeTableRun(uploadArray, uploadSize, uploadIndex);
+  } while (uploadIndex < uploadSize && (clockHandle->nowMicros() - start) < budgetUs);
+
+  if (uploadBank != PAJ7620_BANK0)
+    { selectRegisterBank(BANK0); }  // Park for calls made between slices
+
+  if (uploadIndex >= uploadSize)
+  {
+    bool cursorMode = (uploadArray == setCursorModeRegisterArray);
+    uploadArray = NULL;
+    uploadBank = PAJ7620_BANK0;
+    settleBurstUploads();
+    modeChanged(cursorMode);
+    return false;
+  }
+  return true;
 }
 
 
 /**
- * Returns whether an object is in view as a cursor
- * 
- * \note Only works in cursor mode
+ * Returns whether a queued mode change is still being written
  * \param none
- * \return bool : True if object in view, False if no object in view
+ * \return bool : True if serviceBus() has work left
  */
-bool RevEng_PAJ7620::isCursorInView()
+bool RevEng_PAJ7620::isBusWorkPending()
 {
-  bool result = false;
-  uint8_t data = 0x00;
-  readRegister(PAJ7620_ADDR_CURSOR_INT, 1, &data);
-  switch(data)
-  {
-    case CUR_NO_OBJECT:   result = false;   break;
-    case CUR_HAS_OBJECT:  result = true;    break;
-    default:              result = false;   break;
-  }
-  return result;
+  return uploadArray != NULL;
 }
 
 
 /**
- * Inverts the X (horizontal) axis
- * 
+ * \link PAJ7620_BusSlice \endlink adaptor for \link PAJ7620_BusScheduler \endlink
+ *
  * \par
- * Allows you to choose the orientation of your coordinate system.
- * In all modes, the X axis is inverted. Left becomes Right, etc.
- * For cursor mode, the X values will flip
- * 
- * \param none
- * \return none
+ * Register it with: scheduler.addClient(RevEng_PAJ7620::busSlice, &sensor, priority)
+ * and call scheduler.request(id) after requestGestureMode() / requestCursorMode().
+ * \param driver : pointer to the RevEng_PAJ7620 object
+ * \param budgetUs : microseconds the slice may use the bus for
+ * \return bool : True if more work remains
  */
-void RevEng_PAJ7620::invertXAxis()
+bool RevEng_PAJ7620::busSlice(void *driver, unsigned long budgetUs)
 {
-  uint8_t data = 0x00;
-  selectRegisterBank(BANK1);
-  readRegister(PAJ7620_ADDR_LENS_ORIENTATION, 1, &data);
-  data ^= 1UL << 0;               // Bit[0] controls X axis
-  writeRegister(PAJ7620_ADDR_LENS_ORIENTATION, data);
-  selectRegisterBank(BANK0);
+  return static_cast<RevEng_PAJ7620 *>(driver)->serviceBus(budgetUs);
 }
 
 
 /**
- * Inverts the Y (vertical) axis
- * 
- * \par
- * Allows you to choose the orientation of your coordinate system.
- * In all modes, the Y axis is inverted. Up becomes Down, etc.
- * For cursor mode, the Y values will flip
+ * Gets cursor object's current X location
  * 
+ * \note Only works in cursor mode
  * \param none
- * \return none
+ * \return int : X coordinate of cursor
  */
-void RevEng_PAJ7620::invertYAxis()
+int RevEng_PAJ7620::getCursorX()
 {
-  uint8_t data = 0x00;
-  selectRegisterBank(BANK1);
-  readRegister(PAJ7620_ADDR_LENS_ORIENTATION, 1, &data);
-  data ^= 1UL << 1;                 // Bit[1] controls Y axis
-  writeRegister(PAJ7620_ADDR_LENS_ORIENTATION, data);
-  selectRegisterBank(BANK0);
+  if (snapshotReads)
+    { return lastSnapshot.cursorX; }
+
+  PAJ7620_LockGuard guard(lockHandle);
+  int x = 0, y = 0;
+  readCursor(x, y);
+  return x;
 }
 
 
 /**
- * Disables sensor for reading & interrupts
- * \note This is the light disable state, not the full I2C shutdown state
+ * Gets cursor object's current Y location
+ * 
+ * \note Only works in cursor mode
+ * \param none
+ * \return int : Y coordinate of cursor
+ */
+int RevEng_PAJ7620::getCursorY()
+{
+  if (snapshotReads)
+    { return lastSnapshot.cursorY; }
+
+  PAJ7620_LockGuard guard(lockHandle);
+  int x = 0, y = 0;
+  readCursor(x, y);
+  return y;
+}
+
+
+/**
+ * Reads both cursor coordinates in one burst and applies the orientation
+ *
+ * \par
+ * A rotated X comes from the sensor's Y and vice versa, so both axes are
+ * always read (0x3B..0x3E) and passed through orientCursor().
+ * \param x : set to the oriented X coordinate
+ * \param y : set to the oriented Y coordinate
+ * \return error code; success: return 0
+ */
+uint8_t RevEng_PAJ7620::readCursor(int &x, int &y)
+{
+  uint8_t data[4] = { 0 };          // 0x3B..0x3E: X low, X high, Y low, Y high
+  uint8_t result = readRegister(PAJ7620_ADDR_CURSOR_X_LOW, 4, data);
+  decodeCursor(data, x, y);
+  return result;
+}
+
+
+/**
+ * Converts cursor registers 0x3B..0x3E into oriented coordinates
+ * \param data : X low, X high, Y low, Y high as read from the sensor
+ * \param x : set to the oriented X coordinate
+ * \param y : set to the oriented Y coordinate
+ * \return none
+ */
+void RevEng_PAJ7620::decodeCursor(const uint8_t data[], int &x, int &y)
+{
+  x = ((data[1] & 0x0F) << 8) | data[0];    // Mask off high bits (unused)
+  y = ((data[3] & 0x0F) << 8) | data[2];
+  orientCursor(x, y);
+}
+
+
+/**
+ * Sets cursor mode tuning: filter thresholds, clamp window, size threshold, resolution
+ *
+ * \par
+ * Only the registers that differ from what the sensor already holds are
+ * written, each contiguous run in one I2C burst. Outside cursor mode (or while
+ * a mode change is queued for serviceBus()) the config is stored and written
+ * when cursor mode is entered. It is re-applied after every setCursorMode().
+ * \param config : \link CursorConfig \endlink to use
+ * \return error code: 0 (false) if a field is out of range or the write failed; success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::applyCursorConfig(const CursorConfig &config)
+{
+  if (config.positionFilterStart > 0x1FF || config.processFilterStart > 0x1FF ||
+      config.clampRight > 0x1F || config.clampDown > 0x1F ||
+      config.clampLeft >= config.clampRight || config.clampUp >= config.clampDown ||
+      config.positionResolution > 0x07)
+    { return 0; }
+
+  PAJ7620_LockGuard guard(lockHandle);
+  cursorConfig = config;
+  if (!cursorModeActive || uploadArray)
+    { return 1; }                   // Written on entering cursor mode
+
+  uint8_t regs[PAJ7620_CURSOR_CONFIG_SIZE];
+  encodeCursorConfig(cursorConfig, regs);
+  return writeCursorRegisters(regs) ? 0 : 1;
+}
+
+
+/**
+ * Gets the cursor mode tuning in use
+ * \param config : \link CursorConfig \endlink to fill
+ * \return none
+ */
+void RevEng_PAJ7620::getCursorConfig(CursorConfig &config)
+{
+  config = cursorConfig;
+}
+
+
+/**
+ * Starts interrupt driven cursor tracking
+ *
+ * \par
+ * The cursor mode table enables the has-object and no-object interrupts on
+ * the INT pin. Attach an interrupt routine to that pin which calls
+ * notifyInterrupt(), then call serviceCursorSession() every loop: it only
+ * touches the bus after an INT edge or while an object is in view.
+ * \note Switches to cursor mode if needed. The session ends with
+ *   stopCursorSession() or setGestureMode()
+ * \param none
+ * \return error code: 0 (false); success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::startCursorSession()
+{
+  if (!cursorModeActive)
+    { setCursorMode(); }
+
+  PAJ7620_LockGuard guard(lockHandle);
+  noInterrupts();
+  interruptPending = false;
+  interrupts();
+
+  // An object already in view may have raised its edge before the session
+  // started, so read the current state (this also clears the flags)
+  uint8_t flags = 0;
+  if (readRegister(PAJ7620_ADDR_CURSOR_INT, 1, &flags))
+    { return 0; }
+  cursorPresent = (flags & CUR_HAS_OBJECT) != 0;
+  cursorSession = true;
+  return 1;
+}
+
+
+/**
+ * Ends interrupt driven cursor tracking - the sensor stays in cursor mode
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::stopCursorSession()
+{
+  cursorSession = false;
+  cursorPresent = false;
+}
+
+
+/**
+ * Samples the cursor if an INT edge arrived or an object is in view
+ *
+ * \par
+ * With no object in view and no INT edge since the last call this returns
+ * CURSOR_IDLE without any I2C traffic. Otherwise one burst (0x3B..0x44)
+ * reads the coordinates and the interrupt flags together. The flags are
+ * decoded bitwise: has-object means in view, no-object alone means gone,
+ * neither leaves the state unchanged.
+ * \note CURSOR_IDLE is also returned on a bus error, the edge is kept for
+ *   the next call
+ * \param x : set to the oriented X coordinate on CURSOR_ENTER / CURSOR_MOVE
+ * \param y : set to the oriented Y coordinate on CURSOR_ENTER / CURSOR_MOVE
+ * \return \link CursorEvent \endlink : what happened since the last call
+ */
+CursorEvent RevEng_PAJ7620::serviceCursorSession(int &x, int &y)
+{
+  if (!cursorSession)
+    { return CURSOR_IDLE; }
+
+  noInterrupts();
+  bool edge = interruptPending;
+  interruptPending = false;
+  interrupts();
+  if (!edge && !cursorPresent)
+    { return CURSOR_IDLE; }         // Nothing in view: stay off the bus
+
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t data[PAJ7620_CURSOR_BLOCK_SIZE] = { 0 };
+  if (readRegister(PAJ7620_ADDR_CURSOR_X_LOW, PAJ7620_CURSOR_BLOCK_SIZE, data))
+  {
+    if (edge)
+    {
+      noInterrupts();               // Same access discipline as the ISR flag read
+      interruptPending = true;
+      interrupts();
+    }
+    return CURSOR_IDLE;
+  }
+
+  uint8_t flags = data[PAJ7620_ADDR_CURSOR_INT - PAJ7620_ADDR_CURSOR_X_LOW];
+  bool wasPresent = cursorPresent;
+  if (flags & CUR_HAS_OBJECT)
+    { cursorPresent = true; }
+  else if (flags & CUR_NO_OBJECT)
+    { cursorPresent = false; }
+
+  if (!cursorPresent)
+    { return wasPresent ? CURSOR_EXIT : CURSOR_IDLE; }
+  decodeCursor(data, x, y);
+  return wasPresent ? CURSOR_MOVE : CURSOR_ENTER;
+}
+
+
+/**
+ * Converts a cursor config into register values
+ * \param config : \link CursorConfig \endlink to convert
+ * \param regs : #PAJ7620_CURSOR_CONFIG_SIZE values for 0x33..0x3A then 0x8B..0x8C
+ * \return none
+ */
+void RevEng_PAJ7620::encodeCursorConfig(const CursorConfig &config, uint8_t regs[])
+{
+  regs[0] = config.positionFilterStart & 0xFF;          // 0x33
+  regs[1] = (config.positionFilterStart >> 8) & 0x01;   // 0x34
+  regs[2] = config.processFilterStart & 0xFF;           // 0x35
+  regs[3] = (config.processFilterStart >> 8) & 0x01;    // 0x36
+  regs[4] = config.clampLeft;                           // 0x37
+  regs[5] = config.clampRight;                          // 0x38
+  regs[6] = config.clampUp;                             // 0x39
+  regs[7] = config.clampDown;                           // 0x3A
+  regs[8] = config.objectSizeThreshold;                 // 0x8B
+  regs[9] = config.positionResolution;                  // 0x8C
+}
+
+
+/**
+ * Writes the cursor tuning registers that changed, one burst per run
+ * \note Sensor must be in bank 0. Runs are split up when burst uploads are off
+ * \param regs : #PAJ7620_CURSOR_CONFIG_SIZE values from encodeCursorConfig()
+ * \return error code; success: return 0
+ */
+uint8_t RevEng_PAJ7620::writeCursorRegisters(const uint8_t regs[])
+{
+  // Each run: first index into regs, quantity, register address of first index
+  const uint8_t runs[2][3] = {
+    { 0, PAJ7620_CURSOR_FILTER_RUN, PAJ7620_ADDR_CURSOR_FILTER_START },
+    { PAJ7620_CURSOR_FILTER_RUN, 2, PAJ7620_ADDR_CURSOR_OBJECT_SIZE }
+  };
+
+  for (uint8_t r = 0; r < 2; r++)
+  {
+    int first = -1, last = -1;
+    for (uint8_t i = runs[r][0]; i < runs[r][0] + runs[r][1]; i++)
+    {
+      if (!cursorRegistersKnown || regs[i] != cursorRegisters[i])
+      {
+        if (first < 0) { first = i; }
+        last = i;
+      }
+    }
+    if (first < 0)
+      { continue; }
+
+    uint8_t result = writeRegisterRun(runs[r][2] + (first - runs[r][0]),
+                                      last - first + 1, &regs[first]);
+    if (result)
+    {
+      cursorRegistersKnown = false;
+      return result;
+    }
+    memcpy(&cursorRegisters[first], &regs[first], last - first + 1);
+  }
+  cursorRegistersKnown = true;
+  return 0;
+}
+
+
+/**
+ * Post mode change hook, run once a mode register array is fully written
+ *
+ * \par
+ * Shared by setGestureMode() / setCursorMode() and the sliced serviceBus()
+ * upload. The tables reset the lens orientation and, for cursor mode, the
+ * tuning registers, so the user's axis inversion and
+ * \link CursorConfig \endlink are written back.
+ * \param cursorMode : True if the cursor mode array was written
+ * \return none
+ */
+void RevEng_PAJ7620::modeChanged(bool cursorMode)
+{
+  const unsigned short *table = cursorMode ? setCursorModeRegisterArray
+                                           : setGestureModeRegisterArray;
+  int tableSize = cursorMode ? SET_CURSOR_MODE_REG_ARRAY_SIZE
+                             : SET_GES_MODE_REG_ARRAY_SIZE;
+  cursorModeActive = cursorMode;
+  if (!cursorMode)
+    { stopCursorSession(); }
+
+  // The table reset the lens, put the user's axis inversion back on top
+  uint8_t lens = 0;
+  if (findTableValue(table, tableSize, PAJ7620_BANK1, PAJ7620_ADDR_LENS_ORIENTATION, lens))
+  {
+    lensRegister = lens;
+    writeLens(lens ^ lensFlip);
+  }
+
+  if (!cursorMode)
+    { return; }
+
+  // Record what the table left in the tuning registers
+  for (uint8_t i = 0; i < PAJ7620_CURSOR_CONFIG_SIZE; i++)
+  {
+    uint8_t address = (i < PAJ7620_CURSOR_FILTER_RUN)
+                      ? PAJ7620_ADDR_CURSOR_FILTER_START + i
+                      : PAJ7620_ADDR_CURSOR_OBJECT_SIZE + (i - PAJ7620_CURSOR_FILTER_RUN);
+    findTableValue(table, tableSize, PAJ7620_BANK0, address, cursorRegisters[i]);
+  }
+  cursorRegistersKnown = true;
+
+  uint8_t regs[PAJ7620_CURSOR_CONFIG_SIZE];
+  encodeCursorConfig(cursorConfig, regs);
+  writeCursorRegisters(regs);
+}
+
+
+/**
+ * Finds the last value a register array writes to a register
+ * \param array : register array, same encoding as writeRegisterArray()
+ * \param arraySize : entries in array
+ * \param bank : bank the register is in
+ * \param i2cAddress : register address
+ * \param value : set to the value written, untouched if not found
+ * \return bool : True if the array writes the register
+ */
+bool RevEng_PAJ7620::findTableValue(const unsigned short array[], int arraySize,
+                                    uint8_t bank, uint8_t i2cAddress, uint8_t &value)
+{
+  uint8_t tableBank = PAJ7620_BANK0;
+  bool found = false;
+
+  for (int i = 0; i < arraySize; i++)
+  {
+    uint16_t word = readTableWord(array, i);
+    uint8_t address = (word & 0xFF00) >> 8;
+
+    if (address == PAJ7620_REGISTER_BANK_SEL)
+      { tableBank = word & 0x00FF; }
+    else if (tableBank == bank && address == i2cAddress)
+    {
+      value = word & 0x00FF;
+      found = true;
+    }
+  }
+  return found;
+}
+
+
+/**
+ * Sets how the sensor is mounted: rotation and mirroring
+ *
+ * \par
+ * The setting is absolute - it replaces any earlier invertXAxis() /
+ * invertYAxis() calls. By default the transform is done in software: no I2C
+ * traffic, and the sensor's aim stays centered. Cursor coordinates from
+ * getCursorX() / getCursorY() and directional gestures from readGesture()
+ * come out in the mounted frame: with 90 degrees, a hand moving to the
+ * sensor's up reads as GES_RIGHT.
+ *
+ * \par
+ * With useLens the sensor's lens register flips the axes instead. The lens
+ * cannot swap axes, so only 0 and 180 degrees are possible, and the aim may
+ * move off center (see invertXAxis()). The lens value is cached, so this is
+ * a single register write, and it is kept across mode changes.
+ * \param degrees : clockwise mounting rotation, 0, 90, 180 or 270
+ * \param mirror : True to mirror the X axis (applied before rotating)
+ * \param useLens : True to use the lens register rather than software
+ * \return error code: 0 (false) for an unsupported angle; success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::setOrientation(uint16_t degrees, bool mirror, bool useLens)
+{
+  if (degrees % 90 || degrees > 270 || (useLens && degrees % 180))
+    { return 0; }
+
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t tableLens = lensRegister ^ lensFlip;    // Lens value the mode table set
+
+  if (useLens)
+  {
+    lensFlip = (degrees == 180) ? 0x03 : 0x00;    // Both axes for 180
+    if (mirror)
+      { lensFlip ^= 0x01; }
+    quarterTurns = 0;
+    mirrorX = false;
+  }
+  else
+  {
+    lensFlip = 0x00;
+    quarterTurns = degrees / 90;
+    mirrorX = mirror;
+  }
+  return writeLens(tableLens ^ lensFlip) ? 0 : 1;
+}
+
+
+/**
+ * Applies the software orientation to a cursor position
+ *
+ * \par
+ * Used by getCursorX() / getCursorY(), and available for coordinates from
+ * other sources (Ex: readObjectTelemetry()). No I2C traffic.
+ * \param x : X coordinate, replaced with the oriented one
+ * \param y : Y coordinate, replaced with the oriented one
+ * \return none
+ */
+void RevEng_PAJ7620::orientCursor(int &x, int &y)
+{
+  int t = x;
+  if (mirrorX)
+    { x = PAJ7620_CURSOR_MAX - x; t = x; }
+
+  switch (quarterTurns)
+  {
+    case 1:   x = PAJ7620_CURSOR_MAX - y;   y = t;                        break;
+    case 2:   x = PAJ7620_CURSOR_MAX - x;   y = PAJ7620_CURSOR_MAX - y;   break;
+    case 3:   x = y;                        y = PAJ7620_CURSOR_MAX - t;   break;
+    default:  break;
+  }
+}
+
+
+/**
+ * Applies the software orientation to a gesture
+ *
+ * \par
+ * Directional gestures are rotated with the mounting; a mirror also swaps
+ * left / right and clockwise / anticlockwise. Other gestures pass through.
+ * \param gesture : \link Gesture \endlink in the sensor's frame
+ * \return \link Gesture \endlink in the mounted frame
+ */
+Gesture RevEng_PAJ7620::orientGesture(Gesture gesture)
+{
+  // Directional gestures in clockwise order
+  static const Gesture clockwise[4] = { GES_UP, GES_RIGHT, GES_DOWN, GES_LEFT };
+
+  if (mirrorX)
+  {
+    switch (gesture)
+    {
+      case GES_LEFT:          gesture = GES_RIGHT;          break;
+      case GES_RIGHT:         gesture = GES_LEFT;           break;
+      case GES_CLOCKWISE:     gesture = GES_ANTICLOCKWISE;  break;
+      case GES_ANTICLOCKWISE: gesture = GES_CLOCKWISE;      break;
+      default:                                              break;
+    }
+  }
+
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    if (clockwise[i] == gesture)
+      { return clockwise[(i + quarterTurns) & 0x03]; }
+  }
+  return gesture;
+}
+
+
+/**
+ * Writes the lens orientation register if it differs from the cached value
+ * \param value : new bank 1 0x04 value
+ * \return error code; success: return 0
+ */
+uint8_t RevEng_PAJ7620::writeLens(uint8_t value)
+{
+  if (value == lensRegister)
+    { return 0; }
+
+  selectRegisterBank(BANK1);
+  uint8_t result = writeRegister(PAJ7620_ADDR_LENS_ORIENTATION, value);
+  selectRegisterBank(BANK0);
+  if (!result)
+    { lensRegister = value; }
+  return result;
+}
+
+
+/**
+ * Returns whether an object is in view as a cursor
+ * 
+ * \note Only works in cursor mode
+ * \param none
+ * \return bool : True if object in view, False if no object in view
+ */
+bool RevEng_PAJ7620::isCursorInView()
+{
+  if (snapshotReads)
+    { return lastSnapshot.cursorInView; }
+
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t data = 0x00;
+  readRegister(PAJ7620_ADDR_CURSOR_INT, 1, &data);
+  return (data & CUR_HAS_OBJECT) != 0;    // Other bits may be set alongside it
+}
+
+
+/**
+ * Inverts the X (horizontal) axis
+ * 
+ * \par
+ * Allows you to choose the orientation of your coordinate system.
+ * In all modes, the X axis is inverted. Left becomes Right, etc.
+ * For cursor mode, the X values will flip
+ * \note Toggles the cached lens value - no register read - and the
+ *   inversion is kept across mode changes. See setOrientation().
+ * 
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::invertXAxis()
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  lensFlip ^= 1UL << 0;             // Bit[0] controls X axis
+  writeLens(lensRegister ^ (1UL << 0));
+}
+
+
+/**
+ * Inverts the Y (vertical) axis
+ * 
+ * \par
+ * Allows you to choose the orientation of your coordinate system.
+ * In all modes, the Y axis is inverted. Up becomes Down, etc.
+ * For cursor mode, the Y values will flip
+ * \note Toggles the cached lens value - no register read - and the
+ *   inversion is kept across mode changes. See setOrientation().
+ * 
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::invertYAxis()
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  lensFlip ^= 1UL << 1;             // Bit[1] controls Y axis
+  writeLens(lensRegister ^ (1UL << 1));
+}
+
+
+/**
+ * Disables sensor for reading & interrupts
+ * \note This is the light disable state, not the full I2C shutdown state
  * \param none
  * \return none
  */
 void RevEng_PAJ7620::disable()
 {
+  PAJ7620_LockGuard guard(lockHandle);
+  sensorDisabled = true;
   selectRegisterBank(BANK1);
   writeRegister(PAJ7620_ADDR_OPERATION_ENABLE, PAJ7620_DISABLE);
   selectRegisterBank(BANK0);
@@ -432,6 +1455,8 @@ void RevEng_PAJ7620::disable()
  */
 void RevEng_PAJ7620::enable()
 {
+  PAJ7620_LockGuard guard(lockHandle);
+  sensorDisabled = false;
   selectRegisterBank(BANK1);
   writeRegister(PAJ7620_ADDR_OPERATION_ENABLE, PAJ7620_ENABLE);
   selectRegisterBank(BANK0);
@@ -475,6 +1500,28 @@ void RevEng_PAJ7620::setGestureExitTime(unsigned long newGestureExitTime)
   gestureExitTime = newGestureExitTime;
 }
 
+
+/**
+ * Lets the driver learn entry and exit times per gesture class
+ *
+ * \par
+ * readGesture() then takes its entry window (after left/right, up/down)
+ * and exit window (after forward, backward) from the
+ * \link PAJ7620_AdaptiveTiming \endlink and reports back how soon
+ * forward/backward follow-ups and withdrawal flags really came. Quick users
+ * get shorter windows and faster gestures. The fixed times set with
+ * setGestureEntryTime() / setGestureExitTime() are not used meanwhile.
+ * \note The object is owned by the caller and must outlive its use. Save
+ *   its getTiming() values to keep what was learned across power cycles
+ * \param timing : \link PAJ7620_AdaptiveTiming \endlink to use, NULL for fixed times
+ * \return none
+ */
+void RevEng_PAJ7620::setAdaptiveTiming(PAJ7620_AdaptiveTiming *timing)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  adaptiveTiming = timing;
+}
+
 /*
 void RevEng_PAJ7620::setGameMode()
 {
@@ -530,6 +1577,7 @@ void RevEng_PAJ7620::setGameMode()
  */
 void RevEng_PAJ7620::clearGestureInterrupts()
 {
+    PAJ7620_LockGuard guard(lockHandle);
     uint8_t data = 0, data1 = 0;
     getGesturesReg0(&data);
     getGesturesReg1(&data1);
@@ -543,6 +1591,10 @@ void RevEng_PAJ7620::clearGestureInterrupts()
  */
 int RevEng_PAJ7620::getWaveCount()
 {
+  if (snapshotReads)
+    { return lastSnapshot.object.waveCount; }
+
+  PAJ7620_LockGuard guard(lockHandle);
   uint8_t waveCount = 0;
   readRegister(PAJ7620_ADDR_WAVE_COUNT, 1, &waveCount);
   waveCount &= 0x0F;      // Count is [3:0] bits - values in 0..15
@@ -551,35 +1603,565 @@ int RevEng_PAJ7620::getWaveCount()
 
 
 /**
- * Double check to see if user is executing a Z-axis gesture 
- * 
+ * Cheaply checks whether anything is happening in front of the sensor
+ *
  * \par
- *  This is there the gestureEntryTime and gestureExitTime delays are executed
- *  to buffer high speed polling & return against human gesture speeds.
- * \param initialGesture : The gesture initially found when getGesture() was called
- * \return \link Gesture \endlink : Either the initialGesture or the updated one if the user does another one
+ * Meant for deciding how soon to poll again (see PAJ7620_PollGovernor).
+ * Gesture flags are cleared when read, so in gesture mode only the state
+ * indicator is read and any latched gesture is left for readGesture().
+ * In cursor mode the object and state registers (0x44..0x45) are read in
+ * one burst.
+ * \param none
+ * \return uint8_t : PAJ7620_ACTIVITY_* bits, 0 when idle or on a bus error
  */
-Gesture RevEng_PAJ7620::forwardBackwardGestureCheck(Gesture initialGesture)
+uint8_t RevEng_PAJ7620::readActivity()
 {
-  uint8_t data1 = 0;
-  Gesture result = initialGesture;
+  PAJ7620_LockGuard guard(lockHandle);
+  healthCheckIfDue();
+  uint8_t data[2] = { 0 };          // 0x44, 0x45
+  uint8_t activity = 0;
 
-  delay(gestureEntryTime);
-  getGesturesReg0(&data1);
-  if (data1 == GES_FORWARD_FLAG)
+  if (cursorModeActive)
   {
-    delay(gestureExitTime);
-    result = GES_FORWARD;
+    if (readRegister(PAJ7620_ADDR_CURSOR_INT, 2, data))
+      { return 0; }
+    if (data[0] & CUR_HAS_OBJECT)
+      { activity |= PAJ7620_ACTIVITY_OBJECT; }
   }
-  else if (data1 == GES_BACKWARD_FLAG)
-  {
-    delay(gestureExitTime);
+  else if (readRegister(PAJ7620_ADDR_STATE_INDICATOR, 1, &data[1]))
+    { return 0; }
+
+  if (data[1])
+    { activity |= PAJ7620_ACTIVITY_ENGINE; }
+  return activity;
+}
+
+
+/**
+ * Reads the sensor's object measurements in a single I2C transaction
+ *
+ * \par
+ * Bank 0 registers 0xAC through 0xB7 hold the object's center, average
+ * brightness, size, and the wave count. They are pulled in one burst so all
+ * values come from the same sensor frame, which makes them usable for
+ * presence and distance heuristics in any mode.
+ * \param telemetry : \link ObjectTelemetry \endlink to fill
+ * \return error code: 0 (false); success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::readObjectTelemetry(ObjectTelemetry &telemetry)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t data[PAJ7620_OBJECT_BLOCK_SIZE] = { 0 };
+
+  if (readRegister(PAJ7620_ADDR_OBJECT_CENTER_X_LOW, PAJ7620_OBJECT_BLOCK_SIZE, data))
+    { return 0; }
+
+  decodeObjectTelemetry(data, telemetry);
+  return 1;
+}
+
+
+/**
+ * Unpacks the 0xAC..0xB7 register block
+ * \param data : #PAJ7620_OBJECT_BLOCK_SIZE register values starting at 0xAC
+ * \param telemetry : \link ObjectTelemetry \endlink to fill
+ * \return none
+ */
+void RevEng_PAJ7620::decodeObjectTelemetry(const uint8_t data[], ObjectTelemetry &telemetry)
+{
+  // data[0] is 0xAC, data[11] is 0xB7
+  telemetry.centerX = ((data[1] & 0x1F) << 8) | data[0];    // 0xAD[4:0] : 0xAC
+  telemetry.centerY = ((data[3] & 0x1F) << 8) | data[2];    // 0xAF[4:0] : 0xAE
+  telemetry.brightness = data[4];                           // 0xB0
+  telemetry.size = ((data[6] & 0x0F) << 8) | data[5];       // 0xB2[3:0] : 0xB1
+  telemetry.waveCount = data[11] & 0x0F;                    // 0xB7[3:0]
+}
+
+
+/**
+ * Turns on periodic health checks
+ *
+ * \par
+ * When enabled, readGesture(), poll() and readActivity() run checkHealth()
+ * once intervalMs has passed since the last check. A check is one single
+ * byte register read, so an interval of a few seconds costs next to nothing.
+ * \param intervalMs : ms between checks, 0 turns automatic checks off
+ * \return none
+ */
+void RevEng_PAJ7620::setHealthCheckInterval(unsigned long intervalMs)
+{
+  healthInterval = intervalMs;
+  lastHealthCheck = clockHandle->nowMillis();
+}
+
+
+/**
+ * Checks the sensor is present and has not reset, recovering if it has
+ *
+ * \par
+ * A sensor that browns out or resets loses every register begin() wrote,
+ * and readGesture() would return GES_NONE forever. The canary register
+ * (#PAJ7620_ADDR_HEALTH_CANARY) is compared with the value the driver last
+ * wrote to it - after a reset it reads back its power-on value. On a
+ * mismatch the part ID is verified and the init array, the current mode,
+ * interrupt masks, lens orientation, cursor config, proximity calibration
+ * and disable() state are all written again.
+ * \note Resets can not be seen while the canary's expected value is its
+ *   power-on value #PAJ7620_HEALTH_CANARY_RESET (Ex: a cursor object size
+ *   threshold of 0x10)
+ * \param none
+ * \return error code: 0 (false) if the sensor is missing or could not be re-initialized; success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::checkHealth()
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  return runHealthCheck();
+}
+
+
+/**
+ * Gets the health monitor's counters
+ * \param stats : \link HealthStats \endlink to fill
+ * \return none
+ */
+void RevEng_PAJ7620::getHealthStats(HealthStats &stats)
+{
+  stats = healthStats;
+}
+
+
+/**
+ * Zeroes the health monitor's counters
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::clearHealthStats()
+{
+  memset(&healthStats, 0, sizeof(healthStats));
+}
+
+
+/**
+ * Runs a health check if automatic checks are on and one is due
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::healthCheckIfDue()
+{
+  if (healthInterval && (clockHandle->nowMillis() - lastHealthCheck) >= healthInterval)
+    { runHealthCheck(); }
+}
+
+
+/**
+ * Reads the canary and re-initializes the sensor on a mismatch
+ * \note Lock must be held
+ * \param none
+ * \return error code: 0 (false); success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::runHealthCheck()
+{
+  uint8_t value = 0;
+  lastHealthCheck = clockHandle->nowMillis();
+  healthStats.checks++;
+
+  if (readRegister(PAJ7620_ADDR_HEALTH_CANARY, 1, &value))
+  {
+    healthStats.busErrors++;        // Missing - it is re-initialized when it answers
+    return 0;
+  }
+  if (value == canaryValue)
+    { return 1; }
+
+  healthStats.resets++;
+  if (!reinitialize())
+    { return 0; }
+  healthStats.recoveries++;
+  return 1;
+}
+
+
+/**
+ * Writes all driver state back to a sensor that has reset
+ * \note Lock must be held
+ * \param none
+ * \return error code: 0 (false) if the part ID is wrong; success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::reinitialize()
+{
+  if (!isPAJ7620UDevice())
+    { return 0; }
+
+  initializeDeviceSettings();
+  if (cursorModeActive)
+  {
+    writeRegisterArray(setCursorModeRegisterArray, SET_CURSOR_MODE_REG_ARRAY_SIZE);
+    modeChanged(true);
+  }
+  else
+  {
+    writeRegisterArray(setGestureModeRegisterArray, SET_GES_MODE_REG_ARRAY_SIZE);
+    modeChanged(false);
+  }
+
+  if (uploadArray)
+  {
+    uploadIndex = 0;                // Start a queued mode change over
+    uploadBank = PAJ7620_BANK0;
+  }
+  if (psCalibration.marker == PAJ7620_PS_CAL_MARKER)
+    { applyProximityCalibration(psCalibration); }
+  if (sensorDisabled)
+  {
+    selectRegisterBank(BANK1);
+    writeRegister(PAJ7620_ADDR_OPERATION_ENABLE, PAJ7620_DISABLE);
+    selectRegisterBank(BANK0);
+  }
+  return 1;
+}
+
+
+/**
+ * Measures the ambient proximity level and programs thresholds and gain
+ *
+ * \par
+ * Run with nothing in front of the sensor, in the mode it will be used in.
+ * PS raw data (0x6C) is sampled and its mean and noise (standard deviation)
+ * computed. The high threshold is set a margin above the mean - four times
+ * the noise, at least #PAJ7620_PS_MIN_MARGIN - and the low threshold half
+ * way between, so a hand hovering at the edge does not toggle the INT pin.
+ * If that margin does not fit below full scale (bright sites) the gain is
+ * lowered one step and the measurement repeated. On failure the gain is put
+ * back to its value on entry.
+ * \param cal : \link ProximityCalibration \endlink to fill, keep it to skip calibrating later
+ * \param samples : raw readings to take per attempt (at least 1)
+ * \param sampleIntervalMs : ms between readings
+ * \return error code: 0 (false) if no gain leaves room for thresholds or on a bus error; success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::calibrateProximity(ProximityCalibration &cal, uint8_t samples,
+                                           unsigned long sampleIntervalMs)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t gain = 0;
+
+  selectRegisterBank(BANK1);
+  uint8_t readCode = readRegister(PAJ7620_ADDR_PS_GAIN, 1, &gain);
+  selectRegisterBank(BANK0);
+  if (readCode || samples == 0)
+    { return 0; }
+
+  const uint8_t entryGain = gain;
+  for (uint8_t attempt = 0; attempt <= PAJ7620_PS_GAIN_RETRIES; attempt++)
+  {
+    uint8_t mean = 0, noise = 0;
+    if (sampleAmbient(samples, sampleIntervalMs, mean, noise, guard.held()))
+      { break; }
+
+    unsigned int margin = 4 * noise;
+    if (margin < PAJ7620_PS_MIN_MARGIN)
+      { margin = PAJ7620_PS_MIN_MARGIN; }
+
+    if (mean + margin <= 0xFF)
+    {
+      cal.marker = PAJ7620_PS_CAL_MARKER;
+      cal.highThreshold = mean + margin;
+      cal.lowThreshold = mean + margin / 2;
+      cal.gain = gain;
+      cal.ambientMean = mean;
+      cal.ambientNoise = noise;
+      if (applyProximityCalibration(cal))
+        { return 1; }
+      break;
+    }
+
+    if (gain == 0)
+      { break; }
+    gain--;                         // Too bright for this gain, step down
+    selectRegisterBank(BANK1);
+    writeRegister(PAJ7620_ADDR_PS_GAIN, gain);
+    selectRegisterBank(BANK0);
+  }
+
+  if (gain != entryGain)            // Failed: put back the gain it had on entry
+  {
+    selectRegisterBank(BANK1);
+    writeRegister(PAJ7620_ADDR_PS_GAIN, entryGain);
+    selectRegisterBank(BANK0);
+  }
+  return 0;
+}
+
+
+/**
+ * Programs proximity thresholds and gain from an earlier calibration
+ * \param cal : \link ProximityCalibration \endlink from calibrateProximity() (Ex: read back from EEPROM)
+ * \return error code: 0 (false) if cal is not a valid calibration or on a bus error; success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::applyProximityCalibration(const ProximityCalibration &cal)
+{
+  if (cal.marker != PAJ7620_PS_CAL_MARKER || cal.lowThreshold >= cal.highThreshold)
+    { return 0; }
+
+  PAJ7620_LockGuard guard(lockHandle);
+  const uint8_t thresholds[2] = { cal.highThreshold, cal.lowThreshold };   // 0x69, 0x6A
+
+  selectRegisterBank(BANK1);
+  uint8_t result = writeRegister(PAJ7620_ADDR_PS_GAIN, cal.gain);
+  selectRegisterBank(BANK0);
+  if (!result)
+    { result = writeRegisterRun(PAJ7620_ADDR_PS_HIGH_THRESHOLD, 2, thresholds); }
+  if (result)
+    { return 0; }
+
+  psCalibration = cal;              // Re-applied if the sensor resets
+  return 1;
+}
+
+
+/**
+ * Samples PS raw data and computes its mean and standard deviation
+ * \param samples : readings to take
+ * \param sampleIntervalMs : ms between readings, the lock is released meanwhile
+ * \param mean : set to the mean reading
+ * \param noise : set to the standard deviation, rounded down
+ * \param held : lock the caller's guard took, released while waiting
+ * \return error code; success: return 0
+ */
+uint8_t RevEng_PAJ7620::sampleAmbient(uint8_t samples, unsigned long sampleIntervalMs,
+                                      uint8_t &mean, uint8_t &noise, PAJ7620_Lock *held)
+{
+  uint32_t sum = 0, sumSquares = 0;
+
+  for (uint8_t i = 0; i < samples; i++)
+  {
+    uint8_t raw = 0;
+    uint8_t result = readRegister(PAJ7620_ADDR_PS_RAW_DATA, 1, &raw);
+    if (result)
+      { return result; }
+    sum += raw;
+    sumSquares += (uint32_t)raw * raw;
+    if (i + 1 < samples)
+      { delayUnlocked(held, sampleIntervalMs); }
+  }
+
+  mean = sum / samples;
+  uint32_t variance = sumSquares / samples - (uint32_t)mean * mean;
+  noise = 0;
+  while ((uint32_t)(noise + 1) * (noise + 1) <= variance && noise < 0xFF)
+    { noise++; }
+  return 0;
+}
+
+
+/**
+ * Reads gesture, cursor, state, and object registers into one snapshot
+ *
+ * \par
+ * Replaces a readGesture(), isCursorInView(), getCursorX(), getCursorY(),
+ * getWaveCount() sequence (eight or more transactions) with two bursts:
+ * 0x3B..0x45 (cursor, gesture flags, state) and 0xAC..0xB7 (object, waves).
+ * With setSnapshotReads(true) those getters then answer from this snapshot.
+ * \note Gesture flags are cleared by the read, as with readGesture(), but
+ *   the forward/backward entry & exit delays are not run - poll() never blocks
+ * \param snap : \link SensorSnapshot \endlink to fill
+ * \return error code: 0 (false); success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::poll(SensorSnapshot &snap)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  healthCheckIfDue();
+  uint8_t status[PAJ7620_STATUS_BLOCK_SIZE] = { 0 };
+  uint8_t object[PAJ7620_OBJECT_BLOCK_SIZE] = { 0 };
+
+  if (readRegister(PAJ7620_ADDR_CURSOR_X_LOW, PAJ7620_STATUS_BLOCK_SIZE, status) ||
+      readRegister(PAJ7620_ADDR_OBJECT_CENTER_X_LOW, PAJ7620_OBJECT_BLOCK_SIZE, object))
+    { return 0; }
+
+  // status[0] is 0x3B, status[8] is 0x43, status[10] is 0x45
+  uint8_t flags0 = status[PAJ7620_ADDR_GES_RESULT_0 - PAJ7620_ADDR_CURSOR_X_LOW];
+  uint8_t flags1 = status[PAJ7620_ADDR_GES_RESULT_1 - PAJ7620_ADDR_CURSOR_X_LOW];
+
+  decodeCursor(status, snap.cursorX, snap.cursorY);
+  if (cursorModeActive)
+  {
+    snap.gesture = GES_NONE;        // 0x44 holds object bits in cursor mode
+    snap.cursorInView = (flags1 & CUR_HAS_OBJECT) != 0;
+  }
+  else
+  {
+    snap.gesture = orientGesture(decodeGestureFlags(flags0, flags1));
+    snap.cursorInView = false;
+  }
+  snap.state = status[PAJ7620_STATUS_BLOCK_SIZE - 1];
+  decodeObjectTelemetry(object, snap.object);
+  snap.timestamp = clockHandle->nowMillis();
+
+  lastSnapshot = snap;
+  return 1;
+}
+
+
+/**
+ * Makes the cursor and wave getters answer from the last poll()
+ *
+ * \par
+ * isCursorInView(), getCursorX(), getCursorY() and getWaveCount() then
+ * return values from the same sensor frame with no I2C traffic. Call poll()
+ * once per loop to refresh them. readGesture() always reads the sensor.
+ * \param enable : True to read from the snapshot, False to read the sensor
+ * \return none
+ */
+void RevEng_PAJ7620::setSnapshotReads(bool enable)
+{
+  snapshotReads = enable;
+}
+
+
+/**
+ * Double check to see if user is executing a Z-axis gesture 
+ * 
+ * \par
+ *  This is there the gestureEntryTime and gestureExitTime delays are executed
+ *  to buffer high speed polling & return against human gesture speeds.
+ * \param initialGesture : The gesture initially found when getGesture() was called
+ * \param held : lock the caller's guard took, released while waiting
+ * \return \link Gesture \endlink : Either the initialGesture or the updated one if the user does another one
+ */
+Gesture RevEng_PAJ7620::forwardBackwardGestureCheck(Gesture initialGesture, PAJ7620_Lock *held)
+{
+  if (adaptiveTiming)
+    { return adaptiveEntryCheck(initialGesture, held); }
+
+  uint8_t data1 = 0;
+  Gesture result = initialGesture;
+
+  delayUnlocked(held, gestureEntryTime);
+  getGesturesReg0(&data1);
+  traceStamp(TRACE_CHECK);
+  if (data1 == GES_FORWARD_FLAG)
+  {
+    delayUnlocked(held, gestureExitTime);
+    result = GES_FORWARD;
+  }
+  else if (data1 == GES_BACKWARD_FLAG)
+  {
+    delayUnlocked(held, gestureExitTime);
     result = GES_BACKWARD;
   }
   return result;
 }
 
 
+/**
+ * Forward/backward check with a learned entry window
+ *
+ * \par
+ * Instead of one read after a fixed entry time, the flags are read every
+ * #PAJ7620_TIMING_SLICE_MS until the window for this gesture's class closes,
+ * so a forward/backward follow-up is returned as soon as it is flagged and
+ * its delay is reported to the \link PAJ7620_AdaptiveTiming \endlink.
+ * \param initialGesture : directional gesture flagged by the sensor
+ * \param held : lock the caller's guard took, released while waiting
+ * \return \link Gesture \endlink : initialGesture, or GES_FORWARD / GES_BACKWARD
+ */
+Gesture RevEng_PAJ7620::adaptiveEntryCheck(Gesture initialGesture, PAJ7620_Lock *held)
+{
+  unsigned long start = clockHandle->nowMillis();
+  unsigned long window = adaptiveTiming->window(initialGesture);
+  unsigned long waited = 0;
+
+  do
+  {
+    unsigned long slice = window - waited;
+    delayUnlocked(held, slice < PAJ7620_TIMING_SLICE_MS ? slice : PAJ7620_TIMING_SLICE_MS);
+    uint8_t data1 = 0;
+    getGesturesReg0(&data1);
+    waited = clockHandle->nowMillis() - start;
+
+    if (data1 == GES_FORWARD_FLAG || data1 == GES_BACKWARD_FLAG)
+    {
+      traceStamp(TRACE_CHECK);
+      adaptiveTiming->caught(initialGesture, waited);
+      Gesture result = (data1 == GES_FORWARD_FLAG) ? GES_FORWARD : GES_BACKWARD;
+      exitWait(result, held);
+      return result;
+    }
+  } while (waited < window);
+
+  traceStamp(TRACE_CHECK);
+  adaptiveTiming->passed(initialGesture, start, start + waited);
+  return initialGesture;
+}
+
+
+/**
+ * Waits out the exit time after a forward/backward gesture
+ *
+ * \par
+ * With adaptive timing the flags are read every #PAJ7620_TIMING_SLICE_MS
+ * through the learned exit window and dropped: they are the hand
+ * withdrawing. The delay of the first forward/backward flag is reported to
+ * the \link PAJ7620_AdaptiveTiming \endlink.
+ * \param gesture : GES_FORWARD or GES_BACKWARD
+ * \param held : lock the caller's guard took, released while waiting
+ * \return none
+ */
+void RevEng_PAJ7620::exitWait(Gesture gesture, PAJ7620_Lock *held)
+{
+  if (!adaptiveTiming)
+  {
+    delayUnlocked(held, gestureExitTime);
+    return;
+  }
+
+  unsigned long start = clockHandle->nowMillis();
+  unsigned long window = adaptiveTiming->window(gesture);
+  unsigned long waited = 0;
+  bool withdrawal = false;
+
+  while (waited < window)
+  {
+    unsigned long slice = window - waited;
+    delayUnlocked(held, slice < PAJ7620_TIMING_SLICE_MS ? slice : PAJ7620_TIMING_SLICE_MS);
+    uint8_t data = 0;
+    getGesturesReg0(&data);         // Read clears the withdrawal's flags
+    waited = clockHandle->nowMillis() - start;
+
+    if ((data & (GES_FORWARD_FLAG | GES_BACKWARD_FLAG)) && !withdrawal)
+    {
+      adaptiveTiming->caught(gesture, waited);
+      withdrawal = true;
+    }
+  }
+  if (!withdrawal)
+    { adaptiveTiming->passed(gesture, start, start + waited); }
+}
+
+
+/**
+ * Converts the gesture flag registers into a gesture
+ * \param flags0 : #PAJ7620_ADDR_GES_RESULT_0 (0x43) value
+ * \param flags1 : #PAJ7620_ADDR_GES_RESULT_1 (0x44) value, only checked if flags0 has no gesture
+ * \return \link Gesture \endlink flagged, GES_NONE if none
+ */
+Gesture RevEng_PAJ7620::decodeGestureFlags(uint8_t flags0, uint8_t flags1)
+{
+  switch (flags0)
+  {
+    case GES_RIGHT_FLAG:          return GES_RIGHT;
+    case GES_LEFT_FLAG:           return GES_LEFT;
+    case GES_UP_FLAG:             return GES_UP;
+    case GES_DOWN_FLAG:           return GES_DOWN;
+    case GES_FORWARD_FLAG:        return GES_FORWARD;
+    case GES_BACKWARD_FLAG:       return GES_BACKWARD;
+    case GES_CLOCKWISE_FLAG:      return GES_CLOCKWISE;
+    case GES_ANTI_CLOCKWISE_FLAG: return GES_ANTICLOCKWISE;
+    default:                      break;
+  }
+  return (flags1 == GES_WAVE_FLAG) ? GES_WAVE : GES_NONE;
+}
+
+
 /**
  * Reads the latest gesture from the device
  * 
@@ -593,58 +2175,652 @@ Gesture RevEng_PAJ7620::forwardBackwardGestureCheck(Gesture initialGesture)
  */
 Gesture RevEng_PAJ7620::readGesture()
 {
+  PAJ7620_LockGuard guard(lockHandle);
+  healthCheckIfDue();
   uint8_t data = 0, data1 = 0, readCode = 0;
   Gesture result = GES_NONE;
 
+  if (traceBuffer)
+    { memset(&traceBuffer[traceHead], 0, sizeof(GestureTraceEntry)); }
+
   readCode = getGesturesReg0(&data);
   if (readCode)
   {
+    traceFinish(GES_NONE);
     return GES_NONE;
   }
   else
   {
-    switch (data)
+    traceStamp(TRACE_FLAG_READ);
+    if (decodeGestureFlags(data, 0) == GES_NONE)
+      { getGesturesReg1(&data1); }    // Bank 1 (Reg 0x44) has wave flag
+    result = completeGesture(data, data1, guard.held());
+  }
+  result = orientGesture(result);
+  traceFinish(result);
+  return result;
+}
+
+
+/**
+ * Reads the latest gesture and the engine activity in one I2C transaction
+ *
+ * \par
+ * Same as readGesture(), but both flag registers and the state indicator
+ * (0x43..0x45) are read in a single burst, so an idle poll costs one
+ * transaction. The forward/backward checks only run once a flag is set.
+ * 
+ote Both flag registers are cleared by the burst, so a wave flagged
+ *   together with another gesture is dropped, as in poll()
+ * \param activity : set to the PAJ7620_ACTIVITY_ENGINE bit if the state
+ *   indicator is non-zero, 0 otherwise or on a bus error
+ * 
+eturn \link Gesture \endlink found or \link GES_NONE Gesture::GES_NONE \endlink if no gesture found
+ */
+Gesture RevEng_PAJ7620::readGesture(uint8_t &activity)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  healthCheckIfDue();
+  uint8_t data[3] = { 0 };          // 0x43, 0x44, 0x45
+  Gesture result = GES_NONE;
+  activity = 0;
+
+  if (traceBuffer)
+    { memset(&traceBuffer[traceHead], 0, sizeof(GestureTraceEntry)); }
+
+  if (readRegister(PAJ7620_ADDR_GES_RESULT_0, 3, data))
+  {
+    traceFinish(GES_NONE);
+    return GES_NONE;
+  }
+  traceStamp(TRACE_FLAG_READ);
+  if (data[2])
+    { activity = PAJ7620_ACTIVITY_ENGINE; }
+
+  result = orientGesture(completeGesture(data[0], data[1], guard.held()));
+  traceFinish(result);
+  return result;
+}
+
+
+/**
+ * Decodes read gesture flags and runs the forward/backward checks on them
+ * \param flags0 : value read from 0x43
+ * \param flags1 : value read from 0x44, 0 if not read
+ * \param held : lock the caller's guard took, released while waiting
+ * 
+eturn \link Gesture \endlink found, before orientation
+ */
+Gesture RevEng_PAJ7620::completeGesture(uint8_t flags0, uint8_t flags1, PAJ7620_Lock *held)
+{
+  Gesture result = decodeGestureFlags(flags0, flags1);
+  if (adaptiveTiming)
+    { adaptiveTiming->flagged(result, clockHandle->nowMillis()); }
+
+  switch (result)
+  {
+    case GES_RIGHT:
+    case GES_LEFT:
+    case GES_UP:
+    case GES_DOWN:
+      result = forwardBackwardGestureCheck(result, held);
+      break;
+
+    case GES_FORWARD:
+    case GES_BACKWARD:
+      exitWait(result, held);
+      break;
+
+    default:
+      break;
+  }
+  return result;
+}
+
+
+/**
+ * Captures the sensor's writable configuration registers
+ *
+ * \par
+ * Walks \link snapshotRegisterRanges \endlink and burst reads each run of
+ * registers in a single I2C transaction, switching banks as the table says.
+ * The result can be printed for field diagnostics or written back with restore().
+ * \param snap : \link RegisterSnapshot \endlink to fill
+ * \return error code: 0 (false); success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::snapshot(RegisterSnapshot &snap)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t offset = 0;
+  uint8_t result = 1;
+
+  for (int i = 0; i < (int)SNAPSHOT_RANGE_ARRAY_SIZE; i++)
+  {
+    uint16_t word = readTableWord(snapshotRegisterRanges, i);
+
+    uint8_t address = (word & 0xFF00) >> 8;
+    uint8_t count = (word & 0x00FF);
+
+    if (address == PAJ7620_REGISTER_BANK_SEL)
+      { writeRegister(address, count); }
+    else if (offset + count > PAJ7620_SNAPSHOT_SIZE ||
+             readRegister(address, count, &snap.values[offset]))
+      { result = 0; break; }
+    else
+      { offset += count; }
+  }
+  selectRegisterBank(BANK0);        // Guarantee parking in BANK0
+  return result;
+}
+
+
+/**
+ * Writes a previously captured snapshot back to the sensor
+ *
+ * \par
+ * Only the writable runs in \link snapshotRegisterRanges \endlink are written,
+ * each as one auto-incrementing burst instead of one transaction per register
+ * (one register at a time when burst uploads are off, see setBurstUploads()).
+ * \note The cached lens orientation and gesture / cursor mode are taken from
+ *   the snapshot, so invertXAxis() and friends build on the restored values
+ * \param snap : \link RegisterSnapshot \endlink from an earlier snapshot()
+ * \return error code: 0 (false); success: return 1 (true)
+ */
+uint8_t RevEng_PAJ7620::restore(const RegisterSnapshot &snap)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t offset = 0;
+  uint8_t result = 1;
+
+  for (int i = 0; i < (int)SNAPSHOT_RANGE_ARRAY_SIZE; i++)
+  {
+    uint16_t word = readTableWord(snapshotRegisterRanges, i);
+
+    uint8_t address = (word & 0xFF00) >> 8;
+    uint8_t count = (word & 0x00FF);
+
+    if (address == PAJ7620_REGISTER_BANK_SEL)
+      { writeRegister(address, count); }
+    else if (offset + count > PAJ7620_SNAPSHOT_SIZE ||
+             writeRegisterRun(address, count, &snap.values[offset]))
+      { result = 0; break; }
+    else
+      { offset += count; }
+  }
+  selectRegisterBank(BANK0);        // Guarantee parking in BANK0
+  cursorRegistersKnown = false;     // Snapshot may hold other tuning values
+
+  // The snapshot replaced the lens and mode, so later lens flips and
+  //  health reinitializations must start from what it wrote
+  uint8_t value = 0;
+  if (result && findSnapshotValue(snap, PAJ7620_BANK1, PAJ7620_ADDR_LENS_ORIENTATION, value))
+    { lensRegister = value; }
+  if (result && findSnapshotValue(snap, PAJ7620_BANK1, PAJ7620_ADDR_MODE_SELECT, value))
+  {
+    cursorModeActive = (value == PAJ7620_MODE_CURSOR);
+    if (!cursorModeActive)
+      { stopCursorSession(); }
+  }
+  return result;
+}
+
+
+/**
+ * Finds a register's value in a snapshot
+ * \param snap : \link RegisterSnapshot \endlink to look in
+ * \param bank : bank the register is in
+ * \param i2cAddress : register address
+ * \param value : set to the captured value, untouched if not found
+ * \return bool : True if the snapshot holds the register
+ */
+bool RevEng_PAJ7620::findSnapshotValue(const RegisterSnapshot &snap,
+                                       uint8_t bank, uint8_t i2cAddress, uint8_t &value)
+{
+  uint8_t offset = 0;
+  uint8_t rangeBank = PAJ7620_BANK0;
+
+  for (int i = 0; i < (int)SNAPSHOT_RANGE_ARRAY_SIZE; i++)
+  {
+    uint16_t word = readTableWord(snapshotRegisterRanges, i);
+
+    uint8_t address = (word & 0xFF00) >> 8;
+    uint8_t count = (word & 0x00FF);
+
+    if (address == PAJ7620_REGISTER_BANK_SEL)
+      { rangeBank = count; }
+    else
     {
-      case GES_RIGHT_FLAG:
-        result = forwardBackwardGestureCheck(GES_RIGHT);
-        break;
-
-      case GES_LEFT_FLAG:
-        result = forwardBackwardGestureCheck(GES_LEFT);
-        break;
-
-      case GES_UP_FLAG:
-        result = forwardBackwardGestureCheck(GES_UP);
-        break;
-
-      case GES_DOWN_FLAG:
-        result = forwardBackwardGestureCheck(GES_DOWN);
-        break;
-
-      case GES_FORWARD_FLAG:
-        delay(gestureExitTime);
-        result = GES_FORWARD;
-        break;
-
-      case GES_BACKWARD_FLAG:
-        delay(gestureExitTime);
-        result = GES_BACKWARD;
-        break;
-
-      case GES_CLOCKWISE_FLAG:
-        result = GES_CLOCKWISE;
-        break;
-
-      case GES_ANTI_CLOCKWISE_FLAG:
-        result = GES_ANTICLOCKWISE;
-        break;
-
-      default:
-        getGesturesReg1(&data1);      // Bank 1 (Reg 0x44) has wave flag
-        if (data1 == GES_WAVE_FLAG)
-          { result = GES_WAVE; }
-        break;
+      if (rangeBank == bank && i2cAddress >= address && i2cAddress < address + count)
+      {
+        value = snap.values[offset + (i2cAddress - address)];
+        return true;
+      }
+      offset += count;
     }
   }
-  return result;
+  return false;
+}
+
+
+/**
+ * Prints one line of the register dump format
+ *
+ * \par
+ * Format is: B<bank> <first address>: <value> <value> ...
+ * with all numbers in two digit hex, for example "B0 32: 29 01 00"
+ * \param out : Print stream to write to (Ex: Serial)
+ * \param bank : register bank the values came from
+ * \param i2cAddress : address of the first value
+ * \param byteCount : quantity of values on the line
+ * \param data : the values
+ * \return none
+ */
+void RevEng_PAJ7620::printRegisterLine(Print &out, uint8_t bank, uint8_t i2cAddress,
+                                       uint8_t byteCount, const uint8_t data[])
+{
+  out.print('B');
+  out.print(bank);
+  out.print(' ');
+  if (i2cAddress < 0x10) { out.print('0'); }
+  out.print(i2cAddress, HEX);
+  out.print(':');
+  for (uint8_t i = 0; i < byteCount; i++)
+  {
+    out.print(' ');
+    if (data[i] < 0x10) { out.print('0'); }
+    out.print(data[i], HEX);
+  }
+  out.println();
+}
+
+
+/**
+ * Prints a snapshot in the register dump format
+ *
+ * \par
+ * Output is framed by "PAJ7620 REGS BEGIN" and "PAJ7620 REGS END" lines so a
+ * host script (see scripts/paj7620_regdump.py) can pick it out of other
+ * serial traffic, decode it, and diff it against a capture from another unit.
+ * \param out : Print stream to write to (Ex: Serial)
+ * \param snap : \link RegisterSnapshot \endlink to print
+ * \return none
+ */
+void RevEng_PAJ7620::printSnapshot(Print &out, const RegisterSnapshot &snap)
+{
+  uint8_t offset = 0;
+  uint8_t bank = 0;
+
+  out.println("PAJ7620 REGS BEGIN");
+  for (int i = 0; i < (int)SNAPSHOT_RANGE_ARRAY_SIZE; i++)
+  {
+    uint16_t word = readTableWord(snapshotRegisterRanges, i);
+
+    uint8_t address = (word & 0xFF00) >> 8;
+    uint8_t count = (word & 0x00FF);
+
+    if (address == PAJ7620_REGISTER_BANK_SEL)
+      { bank = count; }
+    else if (offset + count <= PAJ7620_SNAPSHOT_SIZE)
+    {
+      printRegisterLine(out, bank, address, count, &snap.values[offset]);
+      offset += count;
+    }
+  }
+  out.println("PAJ7620 REGS END");
+}
+
+
+/**
+ * Prints every register in bank 0 and bank 1 in the register dump format
+ *
+ * \par
+ * Reads 16 registers per I2C transaction and prints them straight away,
+ * so no large buffer is needed on small microcontrollers.
+ * \note Reading bank 0 0x43 & 0x44 clears any pending gesture interrupts
+ * \param out : Print stream to write to (Ex: Serial)
+ * \return none
+ */
+void RevEng_PAJ7620::printRegisters(Print &out)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  uint8_t data[PAJ7620_I2C_BURST_MAX];
+
+  out.println("PAJ7620 REGS BEGIN");
+  for (uint8_t bank = PAJ7620_BANK0; bank <= PAJ7620_BANK1; bank++)
+  {
+    writeRegister(PAJ7620_REGISTER_BANK_SEL, bank);
+    for (unsigned int address = 0; address < 0x100; address += PAJ7620_I2C_BURST_MAX)
+    {
+      memset(data, 0, sizeof(data));
+      readRegister(address, PAJ7620_I2C_BURST_MAX, data);
+      printRegisterLine(out, bank, address, PAJ7620_I2C_BURST_MAX, data);
+    }
+  }
+  selectRegisterBank(BANK0);        // Guarantee parking in BANK0
+  out.println("PAJ7620 REGS END");
+}
+
+
+/**
+ * Records a sensor interrupt for the gesture trace and cursor sessions
+ *
+ * \par
+ * Call this from the interrupt routine attached to the sensor's INT pin.
+ * The next readGesture() call consumes this time: if it returns a gesture,
+ * the time is traced as its first stage, separating sensor latency from
+ * loop() polling latency.
+ * During a cursor session it tells serviceCursorSession() to read the sensor.
+ * \note Safe to call from an interrupt service routine
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::notifyInterrupt()
+{
+  interruptTime = clockHandle->nowMicros();
+  interruptPending = true;
+}
+
+
+/**
+ * Starts recording a timestamp trace of each gesture read
+ *
+ * \par
+ * Every readGesture() call that returns a gesture stores one
+ * \link GestureTraceEntry \endlink with the INT edge (if notifyInterrupt()
+ * is wired up), flag read, forward/backward check, and return times.
+ * The buffer is used as a ring, keeping the latest depth gestures.
+ * \note The buffer is owned by the caller and must outlive the trace
+ * \param buffer : array of \link GestureTraceEntry \endlink to record into
+ * \param depth : quantity of entries in buffer
+ * \return none
+ */
+void RevEng_PAJ7620::enableGestureTrace(GestureTraceEntry buffer[], uint8_t depth)
+{
+  traceBuffer = (depth > 0) ? buffer : NULL;
+  traceDepth = depth;
+  clearGestureTrace();
+}
+
+
+/**
+ * Stops the gesture trace - the buffer is no longer touched
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::disableGestureTrace()
+{
+  traceBuffer = NULL;
+  traceDepth = 0;
+  clearGestureTrace();
+}
+
+
+/**
+ * Drops all recorded gesture trace entries
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::clearGestureTrace()
+{
+  traceHead = 0;
+  traceCount = 0;
+  interruptTime = 0;
+}
+
+
+/**
+ * Prints the recorded gesture trace, oldest entry first
+ *
+ * \par
+ * Output is framed by "PAJ7620 TRACE BEGIN" and "PAJ7620 TRACE END" lines
+ * with a CSV header and one line per gesture:
+ *   gesture,interrupt_us,flag_us,check_us,return_us
+ * scripts/paj7620_latency.py turns a captured trace into per stage percentiles.
+ * \param out : Print stream to write to (Ex: Serial)
+ * \return none
+ */
+void RevEng_PAJ7620::printGestureTrace(Print &out)
+{
+  out.println("PAJ7620 TRACE BEGIN");
+  out.println("gesture,interrupt_us,flag_us,check_us,return_us");
+  for (uint8_t i = 0; i < traceCount; i++)
+  {
+    uint8_t slot = (traceHead + traceDepth - traceCount + i) % traceDepth;
+    out.print(traceBuffer[slot].gesture);
+    for (uint8_t stage = 0; stage < TRACE_STAGE_COUNT; stage++)
+    {
+      out.print(',');
+      out.print(traceBuffer[slot].stageTime[stage]);
+    }
+    out.println();
+  }
+  out.println("PAJ7620 TRACE END");
+}
+
+
+/**
+ * Timestamps a stage of the gesture being traced, if tracing is on
+ * \param stage : \link GestureTraceStage \endlink reached
+ * \return none
+ */
+void RevEng_PAJ7620::traceStamp(GestureTraceStage stage)
+{
+  if (traceBuffer)
+    { traceBuffer[traceHead].stageTime[stage] = clockHandle->nowMicros(); }
+}
+
+
+/**
+ * Completes the traced entry and keeps it if a gesture was found
+ * \note The INT edge time is consumed either way, so an edge that led to
+ *   no gesture (Ex: a hand leaving) is not charged to a later gesture
+ * \param result : \link Gesture \endlink readGesture() is returning
+ * \return none
+ */
+void RevEng_PAJ7620::traceFinish(Gesture result)
+{
+  if (!traceBuffer)
+    { return; }
+
+  noInterrupts();                   // interruptTime is multi-byte on 8 bit parts
+  unsigned long edgeTime = interruptTime;
+  interruptTime = 0;
+  interrupts();
+  if (result == GES_NONE)
+    { return; }
+
+  GestureTraceEntry &entry = traceBuffer[traceHead];
+  entry.stageTime[TRACE_INTERRUPT] = edgeTime;
+  entry.stageTime[TRACE_RETURN] = clockHandle->nowMicros();
+  entry.gesture = result;
+
+  traceHead = (traceHead + 1) % traceDepth;
+  if (traceCount < traceDepth)
+    { traceCount++; }
+}
+
+
+/**
+ * Turns on the thread-safe mode by sharing a lock with the driver
+ *
+ * \par
+ * With a lock set, every public call that touches the sensor holds it for
+ * its whole I2C sequence (bank switch, access, bank restore), so calls made
+ * from several threads or RTOS tasks cannot interleave their bank switches.
+ * The lock is released while readGesture() waits out the entry and exit times.
+ * Use PAJ7620_FreeRTOSLock on ESP32 or PAJ7620_StdLock on host builds.
+ * \note The lock must be recursive and outlive its use by the driver
+ * \param lock : pointer to a \link PAJ7620_Lock \endlink, or NULL to turn locking off
+ * \return none
+ */
+void RevEng_PAJ7620::setLock(PAJ7620_Lock *lock)
+{
+  lockHandle = lock;
+}
+
+
+/**
+ * Sets the time source for every delay and timestamp the driver takes
+ *
+ * \par
+ * Gesture entry/exit delays, the begin() settle time, health check and
+ * poll() timestamps, gesture trace and I2C trace times all come from it.
+ * Host tests pass a \link PAJ7620_SimClock \endlink to run timed gesture
+ * scenarios without waiting. Can be called before begin().
+ * \note The clock is owned by the caller and must outlive its use
+ * \param clock : \link PAJ7620_Clock \endlink to use, NULL for the Arduino core
+ * \return none
+ */
+void RevEng_PAJ7620::setClockSource(PAJ7620_Clock *clock)
+{
+  clockHandle = clock ? clock : &PAJ7620_ArduinoClock::shared;
+}
+
+
+/**
+ * Gets the driver's time source, for helpers that time sensor samples
+ * \param none
+ * \return PAJ7620_Clock* : the clock in use, never NULL
+ */
+PAJ7620_Clock *RevEng_PAJ7620::getClockSource()
+{
+  return clockHandle;
+}
+
+
+/**
+ * Waits the given time with the driver lock released
+ * \note Callers must hold the lock exactly once, so the single unlock
+ *   here really frees the bus for other tasks. The lock is the one their
+ *   guard took, not lockHandle, which setLock() may swap meanwhile
+ * \param held : lock held by the caller (NULL: none)
+ * \param ms : milliseconds to wait
+ * \return none
+ */
+void RevEng_PAJ7620::delayUnlocked(PAJ7620_Lock *held, unsigned long ms)
+{
+  if (held) { held->unlock(); }
+  clockHandle->sleepMillis(ms);
+  if (held) { held->lock(); }
+}
+
+
+#if defined(ARDUINO_ARCH_ESP32)
+/**
+ * Starts a FreeRTOS task that owns gesture polling (ESP32 only)
+ *
+ * \par
+ * The task calls readGesture() every pollPeriodMs and publishes each gesture
+ * found to a queue, read from any task with receiveGesture(). Other calls
+ * (Ex: setCursorMode()) stay safe from any task since all bus access is
+ * serialized through the driver lock - one is created if setLock() was not used.
+ * \param pollPeriodMs : milliseconds between polls, rounded up to at least one tick
+ * \param priority : FreeRTOS priority of the sensor task
+ * \param queueDepth : quantity of gestures buffered for receiveGesture()
+ * \return bool : True if the task is running
+ */
+bool RevEng_PAJ7620::startSensorTask(unsigned long pollPeriodMs, UBaseType_t priority,
+                                     uint8_t queueDepth)
+{
+  if (sensorTask)
+    { return true; }
+
+  if (!lockHandle)
+  {
+    if (!taskLock)
+      { taskLock = new PAJ7620_FreeRTOSLock(); }
+    lockHandle = taskLock;
+  }
+
+  if (!gestureQueue)
+    { gestureQueue = xQueueCreate(queueDepth, sizeof(Gesture)); }
+  if (!gestureQueue)
+    { return false; }
+
+  sensorTaskPeriod = pollPeriodMs;
+  sensorTaskStop = false;
+  TaskHandle_t task = NULL;
+  if (xTaskCreate(sensorTaskLoop, "PAJ7620", 2048, this, priority, &task) != pdPASS)
+    { return false; }
+  sensorTask = task;
+  return true;
+}
+
+
+/**
+ * Stops the sensor task started by startSensorTask() (ESP32 only)
+ *
+ * \par
+ * The task is asked to stop and ends itself between polls, so it is never
+ * deleted mid-transaction or while holding the driver lock. This call
+ * returns once it has ended, which can take up to one poll period.
+ * \note Gestures already queued can still be read with receiveGesture()
+ * \param none
+ * \return none
+ */
+void RevEng_PAJ7620::stopSensorTask()
+{
+  if (!sensorTask)
+    { return; }
+
+  sensorTaskStop = true;
+  while (sensorTask)
+    { vTaskDelay(1); }
+  sensorTaskStop = false;
+}
+
+
+/**
+ * Waits for the next gesture published by the sensor task (ESP32 only)
+ * \param gesture : set to the \link Gesture \endlink received
+ * \param timeoutMs : milliseconds to wait for a gesture
+ * \return bool : True if a gesture was received, False on timeout
+ */
+bool RevEng_PAJ7620::receiveGesture(Gesture &gesture, unsigned long timeoutMs)
+{
+  if (!gestureQueue)
+    { return false; }
+  return xQueueReceive(gestureQueue, &gesture, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+
+/**
+ * Body of the sensor task - polls readGesture() and publishes results
+ * \param driver : the RevEng_PAJ7620 object that started the task
+ * \return none
+ */
+void RevEng_PAJ7620::sensorTaskLoop(void *driver)
+{
+  RevEng_PAJ7620 *sensor = static_cast<RevEng_PAJ7620 *>(driver);
+  TickType_t lastWake = xTaskGetTickCount();
+
+  while (!sensor->sensorTaskStop)
+  {
+    Gesture gesture = sensor->readGesture();
+    if (gesture != GES_NONE)
+      { xQueueSend(sensor->gestureQueue, &gesture, 0); }
+    TickType_t period = pdMS_TO_TICKS(sensor->sensorTaskPeriod);
+    vTaskDelayUntil(&lastWake, period ? period : 1);   // Zero asserts
+  }
+  sensor->sensorTask = NULL;        // Lets stopSensorTask() return
+  vTaskDelete(NULL);
+}
+#endif
+
+
+/**
+ * Attaches an I2C trace to record or replay every register transaction
+ *
+ * \par
+ * While the trace is recording, each register read and write is appended
+ * to it with a timestamp. While it is replaying, the bus is not used at all:
+ * reads are answered from the trace and writes are checked against it, so a
+ * captured field session can be rerun deterministically as a test fixture.
+ * \param trace : pointer to a \link PAJ7620_I2CTrace \endlink, or NULL to detach
+ * \return none
+ */
+void RevEng_PAJ7620::setI2CTrace(PAJ7620_I2CTrace *trace)
+{
+  PAJ7620_LockGuard guard(lockHandle);
+  i2cTrace = trace;
 }
@@ -56,6 +56,11 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+#include "RevEng_PAJ7620_Lock.h"
+#include "RevEng_PAJ7620_Clock.h"
+#include "RevEng_PAJ7620_BusScheduler.h"
+#include "RevEng_PAJ7620_I2CTrace.h"
+
 /* Changed to JayCar-Electronics PROGMEM approach from <a href="https://github.com/Jaycar-Electronics">their fork</a>.
  * This is used for the various initialization and mode register arrays.
  * Saves about 5% of SRAM on an Arduino Uno - Around 100 bytes for the init array.
@@ -104,6 +109,36 @@ typedef enum {
 
 /** Register bank select address */
 #define PAJ7620_REGISTER_BANK_SEL         (PAJ7620_ADDR_BASE + 0xEF)  // W
+
+/** Largest register run moved in one I2C transaction (AVR Wire buffer is 32 bytes) */
+#define PAJ7620_I2C_BURST_MAX             16
+/**@}*/
+
+/** @name I2C bus clock settings for begin() and probeBusSpeed() */
+/**@{*/
+/** Standard mode, the slowest speed probed */
+#define PAJ7620_I2C_CLOCK_MIN             100000UL
+/** Fast mode, the PAJ7620's limit */
+#define PAJ7620_I2C_CLOCK_MAX             400000UL
+/** Step between the speeds probed */
+#define PAJ7620_I2C_CLOCK_STEP            100000UL
+/** begin() clock value: leave the bus clock as the Wire library set it */
+#define PAJ7620_I2C_CLOCK_KEEP            0UL
+/** begin() clock value: run probeBusSpeed() and use its result */
+#define PAJ7620_I2C_CLOCK_PROBE           1UL
+/** Part-ID and scratch round trips each probed speed must pass */
+#define PAJ7620_PROBE_ROUNDS              8
+/**@}*/
+
+/** @name Register table upload modes for setBurstUploads() */
+/**@{*/
+/** One transaction per table entry */
+#define PAJ7620_BURST_OFF                 0
+/** Runs of consecutive registers in one auto-increment transaction */
+#define PAJ7620_BURST_ON                  1
+/** As PAJ7620_BURST_ON, each run read back until an upload reads back clean,
+ *  then PAJ7620_BURST_ON - falls back to PAJ7620_BURST_OFF on a mismatch (default) */
+#define PAJ7620_BURST_VERIFY              2
 /**@}*/
 
 /** @name ID values 
@@ -160,6 +195,29 @@ typedef enum {
 #define PAJ7620_ADDR_CURSOR_Y_HIGH        (PAJ7620_ADDR_BASE + 0x3E)  // R
 /** \note Readonly */
 #define PAJ7620_ADDR_CURSOR_INT           (PAJ7620_ADDR_BASE + 0x44)  // R
+
+// Object Registers - Bank 0
+/** \note Readonly */
+#define PAJ7620_ADDR_OBJECT_CENTER_X_LOW  (PAJ7620_ADDR_BASE + 0xAC)  // R
+/** \note Readonly */
+#define PAJ7620_ADDR_OBJECT_CENTER_X_HIGH (PAJ7620_ADDR_BASE + 0xAD)  // R
+/** \note Readonly */
+#define PAJ7620_ADDR_OBJECT_CENTER_Y_LOW  (PAJ7620_ADDR_BASE + 0xAE)  // R
+/** \note Readonly */
+#define PAJ7620_ADDR_OBJECT_CENTER_Y_HIGH (PAJ7620_ADDR_BASE + 0xAF)  // R
+/** \note Readonly */
+#define PAJ7620_ADDR_OBJECT_BRIGHTNESS    (PAJ7620_ADDR_BASE + 0xB0)  // R
+/** \note Readonly */
+#define PAJ7620_ADDR_OBJECT_SIZE_LOW      (PAJ7620_ADDR_BASE + 0xB1)  // R
+/** \note Readonly */
+#define PAJ7620_ADDR_OBJECT_SIZE_HIGH     (PAJ7620_ADDR_BASE + 0xB2)  // R
+
+/** Quantity of registers from object center X through the wave count */
+#define PAJ7620_OBJECT_BLOCK_SIZE         (PAJ7620_ADDR_WAVE_COUNT - PAJ7620_ADDR_OBJECT_CENTER_X_LOW + 1)
+/** Quantity of registers from cursor X low through the state indicator (0x3B..0x45) */
+#define PAJ7620_STATUS_BLOCK_SIZE         (PAJ7620_ADDR_STATE_INDICATOR - PAJ7620_ADDR_CURSOR_X_LOW + 1)
+/** Quantity of registers from cursor X low through the cursor interrupt flags (0x3B..0x44) */
+#define PAJ7620_CURSOR_BLOCK_SIZE         (PAJ7620_ADDR_CURSOR_INT - PAJ7620_ADDR_CURSOR_X_LOW + 1)
 /**@}*/
 
 // REGISTER BANK 1
@@ -187,6 +245,8 @@ typedef enum {
 #define PAJ7620_ADDR_OP_TO_S2_STEP_1      (PAJ7620_ADDR_BASE + 0x6E)  // RW
 /** \note Read/Write */
 #define PAJ7620_ADDR_OPERATION_ENABLE     (PAJ7620_ADDR_BASE + 0x72)  // RW
+/** \note Read/Write */
+#define PAJ7620_ADDR_MODE_SELECT          (PAJ7620_ADDR_BASE + 0x74)  // RW
 
 // Cursor Registers - Bank 1
 /** \note Read/Write */
@@ -219,6 +279,16 @@ typedef enum {
 #define PAJ7620_DISABLE                   0x00
 /**@}*/
 
+/** @name Mode select values
+ * Written to #PAJ7620_ADDR_MODE_SELECT (Bank 1)
+ */
+/**@{*/
+/** Gesture mode */
+#define PAJ7620_MODE_GESTURE              0x00
+/** Cursor mode */
+#define PAJ7620_MODE_CURSOR               0x03
+/**@}*/
+
 /** @name Gesture Bit Masks
  * Return values from gesture I2C memory reads in Bank 0 - 0x43 & 0x44
  *
@@ -251,6 +321,17 @@ typedef enum {
 #define CUR_HAS_OBJECT                    0x04      // Bit 2 - 0000 0100
 #define CUR_NO_OBJECT                     0x80      // Bit 7 - 1000 0000
 
+/** @name Activity bits returned by readActivity() */
+/**@{*/
+/** Cursor mode: an object is in view (#PAJ7620_ADDR_CURSOR_INT bit 2) */
+#define PAJ7620_ACTIVITY_OBJECT           0x01
+/** Gesture engine is busy: #PAJ7620_ADDR_STATE_INDICATOR is non-zero */
+#define PAJ7620_ACTIVITY_ENGINE           0x02
+/**@}*/
+
+/** Largest cursor coordinate (12 bit), software orientation flips around it */
+#define PAJ7620_CURSOR_MAX                0x0FFF
+
 
 
 /** Generated size of the register init array */
@@ -417,6 +498,216 @@ const unsigned short setCursorModeRegisterArray[] = {
 };
 
 
+/** Generated size of the snapshot register range array */
+#define SNAPSHOT_RANGE_ARRAY_SIZE (sizeof(snapshotRegisterRanges)/sizeof(snapshotRegisterRanges[0]))
+
+/** Total quantity of register values held by a \link RegisterSnapshot \endlink */
+#define PAJ7620_SNAPSHOT_SIZE             68
+
+/**
+ * Writable register runs captured by snapshot() and written back by restore()
+ * \note Same encoding as the mode arrays except the second byte is a run length:
+ *   0xEFxx selects bank xx, otherwise high byte is the first address, low byte the count
+ * \note Covers every register touched by the init and mode arrays plus the PS thresholds & gain
+ * \note Run lengths must add up to #PAJ7620_SNAPSHOT_SIZE
+ */
+#ifdef PROGMEM_COMPATIBLE
+const unsigned short snapshotRegisterRanges[] PROGMEM = {
+#else
+const unsigned short snapshotRegisterRanges[] = {
+#endif
+    0xEF00,   // Bank 0
+    0x3209,   // 0x32..0x3A Cursor options, filter thresholds, clamp window
+    0x4102,   // 0x41..0x42 Interrupt enable masks
+    0x4605,   // 0x46..0x4A
+    0x4C01,
+    0x5101,
+    0x5E01,
+    0x6001,
+    0x6902,   // 0x69..0x6A PS high & low thresholds
+    0x8004,   // 0x80..0x83
+    0x8B02,   // 0x8B..0x8C Cursor object size threshold, position resolution
+    0x9001,
+    0x9503,   // 0x95..0x97
+    0x9A01,
+    0x9C01,
+    0x9F01,
+    0xA501,
+    0xCC05,   // 0xCC..0xD0
+    0xEF01,   // Bank 1
+    0x0104,   // 0x01..0x04 Includes lens orientation
+    0x2501,
+    0x2703,   // 0x27..0x29
+    0x3E01,
+    0x4101,
+    0x4302,   // 0x43..0x44 Includes PS gain
+    0x5E01,
+    0x650A,   // 0x65..0x6E Idle & operation step timing
+    0x7203,   // 0x72..0x74 Operation enable and mode select
+    0x7701,
+    0xEF00    // Bank 0 (parking it)
+};
+
+
+/**
+ * Compact copy of the sensor's writable configuration registers
+ * \note Layout follows \link snapshotRegisterRanges \endlink in order
+ */
+struct RegisterSnapshot {
+  uint8_t values[PAJ7620_SNAPSHOT_SIZE];  /**< Register values, run after run */
+};
+
+
+/**
+ * Object measurements computed by the sensor, read by readObjectTelemetry()
+ * \note Updated by the sensor in gesture, cursor, and proximity modes
+ */
+struct ObjectTelemetry {
+  uint16_t centerX;       /**< Object center X [12:0] */
+  uint16_t centerY;       /**< Object center Y [12:0] */
+  uint8_t brightness;     /**< Object average brightness [7:0] */
+  uint16_t size;          /**< Object size in pixels [11:0] */
+  uint8_t waveCount;      /**< Wave count [3:0] - same as getWaveCount() */
+};
+
+
+/**
+ * Everything the sensor reports, read together by poll()
+ * \note All values come from two I2C bursts (0x3B..0x45 and 0xAC..0xB7), so
+ *   they belong to the same (or adjacent) sensor frames
+ */
+struct SensorSnapshot {
+  Gesture gesture;          /**< Gesture mode: flagged \link Gesture \endlink (no entry/exit delays), else GES_NONE */
+  bool cursorInView;        /**< Cursor mode: object in view */
+  int cursorX;              /**< Cursor X, after setOrientation() */
+  int cursorY;              /**< Cursor Y, after setOrientation() */
+  uint8_t state;            /**< State indicator (0x45) */
+  ObjectTelemetry object;   /**< Object measurements, includes the wave count */
+  unsigned long timestamp;  /**< millis() when read, from the driver's clock source */
+};
+
+
+/** @name Proximity calibration constants */
+/**@{*/
+/** Marks a \link ProximityCalibration \endlink filled by calibrateProximity() */
+#define PAJ7620_PS_CAL_MARKER             0xC5
+/** Smallest gap in raw counts between the ambient level and the high threshold */
+#define PAJ7620_PS_MIN_MARGIN             16
+/** Attempts at a lower gain when the ambient level leaves no room for thresholds */
+#define PAJ7620_PS_GAIN_RETRIES           4
+/**@}*/
+
+/**
+ * Proximity thresholds and gain chosen by calibrateProximity()
+ * \note Plain data: store it (Ex: EEPROM.put()) and hand it to
+ *   applyProximityCalibration() on later boots to skip calibration
+ */
+struct ProximityCalibration {
+  uint8_t marker;           /**< #PAJ7620_PS_CAL_MARKER when valid */
+  uint8_t highThreshold;    /**< Approach threshold (0x69), raw counts */
+  uint8_t lowThreshold;     /**< Release threshold (0x6A), below highThreshold for hysteresis */
+  uint8_t gain;             /**< PS gain register value (bank 1, 0x44) */
+  uint8_t ambientMean;      /**< Mean raw reading during calibration */
+  uint8_t ambientNoise;     /**< Standard deviation of the raw readings */
+};
+
+
+/** @name Health monitor constants */
+/**@{*/
+/** Register compared against the last value written to detect a sensor reset */
+#define PAJ7620_ADDR_HEALTH_CANARY        PAJ7620_ADDR_CURSOR_OBJECT_SIZE
+/** Power-on value of the canary register, the init array changes it */
+#define PAJ7620_HEALTH_CANARY_RESET       0x10
+/**
+ * Register written and read back by probeBusSpeed(), its value is restored after.
+ * It is the health canary on purpose: the driver already knows its value, so
+ * no read is needed to restore it, and a failed restore shows up as a canary
+ * mismatch. The cursor object size threshold is off while the probe runs.
+ */
+#define PAJ7620_ADDR_PROBE_SCRATCH        PAJ7620_ADDR_HEALTH_CANARY
+/**@}*/
+
+/**
+ * Counters kept by the health monitor
+ * \see RevEng_PAJ7620::setHealthCheckInterval()
+ */
+struct HealthStats {
+  unsigned long checks;       /**< Health checks run */
+  unsigned long resets;       /**< Sensor resets (canary mismatches) detected */
+  unsigned long recoveries;   /**< Re-initializations that succeeded */
+  unsigned long busErrors;    /**< Checks where the sensor did not answer */
+};
+
+
+/** @name Cursor tuning registers written by applyCursorConfig() */
+/**@{*/
+/** First of the filter threshold & clamp window run (0x33..0x3A) */
+#define PAJ7620_ADDR_CURSOR_FILTER_START  (PAJ7620_ADDR_BASE + 0x33)  // RW
+/** First of the object size threshold & resolution run (0x8B..0x8C) */
+#define PAJ7620_ADDR_CURSOR_OBJECT_SIZE   (PAJ7620_ADDR_BASE + 0x8B)  // RW
+/** Registers in the 0x33..0x3A run */
+#define PAJ7620_CURSOR_FILTER_RUN         8
+/** Register values held for a \link CursorConfig \endlink: 0x33..0x3A, 0x8B..0x8C */
+#define PAJ7620_CURSOR_CONFIG_SIZE        (PAJ7620_CURSOR_FILTER_RUN + 2)
+/**@}*/
+
+/**
+ * Cursor mode tuning, set with applyCursorConfig()
+ * \note Defaults are the values in \link setCursorModeRegisterArray \endlink,
+ *   read them with getCursorConfig() and change what you need
+ * \note Clamp values trim the edges of the sensor's 32x32 view: a smaller
+ *   window (left..right, up..down) tracks over a shorter hand travel
+ */
+struct CursorConfig {
+  uint16_t positionFilterStart;   /**< Object size to start position filtering [8:0] - 0x33/0x34 */
+  uint16_t processFilterStart;    /**< Object size to start processing [8:0] - 0x35/0x36 */
+  uint8_t clampLeft;              /**< Clamp window left edge [4:0] - 0x37 */
+  uint8_t clampRight;             /**< Clamp window right edge [4:0], above clampLeft - 0x38 */
+  uint8_t clampUp;                /**< Clamp window top edge [4:0] - 0x39 */
+  uint8_t clampDown;              /**< Clamp window bottom edge [4:0], above clampUp - 0x3A */
+  uint8_t objectSizeThreshold;    /**< Smallest object reported as a cursor [7:0] - 0x8B */
+  uint8_t positionResolution;     /**< Position resolution [2:0] - 0x8C */
+};
+
+
+/**
+  Results of serviceCursorSession()
+  \see RevEng_PAJ7620::startCursorSession()
+ */
+enum CursorEvent {
+  CURSOR_IDLE = 0,      /**< No object in view - nothing was read */
+  CURSOR_ENTER,         /**< Object came into view, coordinates are valid */
+  CURSOR_MOVE,          /**< Object still in view, coordinates are valid */
+  CURSOR_EXIT,          /**< Object left the view */
+};
+
+
+/**
+  Stages of a readGesture() call timestamped by the gesture trace
+  \see RevEng_PAJ7620::enableGestureTrace()
+ */
+enum GestureTraceStage {
+  TRACE_INTERRUPT = 0,  /**< INT pin edge, as reported by notifyInterrupt() */
+  TRACE_FLAG_READ,      /**< Gesture flags read from the sensor */
+  TRACE_CHECK,          /**< Forward/backward disambiguation read done */
+  TRACE_RETURN,         /**< readGesture() about to return */
+  TRACE_STAGE_COUNT     /**< Quantity of stages */
+};
+
+
+/**
+ * Timestamps of one traced gesture
+ * \note Times are micros() values, 0 means the stage did not happen
+ */
+struct GestureTraceEntry {
+  unsigned long stageTime[TRACE_STAGE_COUNT]; /**< Indexed by \link GestureTraceStage \endlink */
+  uint8_t gesture;                            /**< \link Gesture \endlink returned */
+};
+
+
+class PAJ7620_AdaptiveTiming;      // RevEng_PAJ7620_AdaptiveTiming.h
+
+
 /**
  * PAJ7620 Device API class - As developed by RevEng Devs
  *
@@ -426,8 +717,18 @@ const unsigned short setCursorModeRegisterArray[] = {
 class RevEng_PAJ7620
 {
   public:
+    RevEng_PAJ7620();
+    ~RevEng_PAJ7620();
+
     uint8_t begin();
     uint8_t begin(TwoWire * chosenWireHandle);    // Ex: begin(&Wire1)
+    uint8_t begin(TwoWire * chosenWireHandle, uint32_t busClockHz);   // Ex: begin(&Wire, 400000)
+
+    /** @name Bus speed interface */
+    /**@{*/
+    uint32_t probeBusSpeed(uint8_t rounds = PAJ7620_PROBE_ROUNDS, uint8_t marginSteps = 1);
+    uint32_t getBusClock();         // Clock set by the driver, 0 if left to Wire
+    /**@}*/
 
     void disable();                 // Suspend interrupts (both pin and registers)
     void enable();                  // Resume interrupts (both pin and registers)
@@ -436,6 +737,23 @@ class RevEng_PAJ7620
     /**@{*/
     void setGestureMode();          // Put sensor into gesture mode
     void setCursorMode();           // Put sensor into cursor mode
+
+    void setBurstUploads(uint8_t mode);     // PAJ7620_BURST_*, before begin() to cover it
+    uint8_t getBurstUploads();              // Verify result: PAJ7620_BURST_ON or _OFF
+    /**@}*/
+
+    /** @name Shared bus (sliced) interface */
+    /**@{*/
+    void requestGestureMode();      // Queue mode change, written by serviceBus()
+    void requestCursorMode();
+    bool serviceBus(unsigned long budgetUs);
+    bool isBusWorkPending();
+    static bool busSlice(void *driver, unsigned long budgetUs);  // For PAJ7620_BusScheduler
+    /**@}*/
+
+    /** @name I2C trace record / replay interface */
+    /**@{*/
+    void setI2CTrace(PAJ7620_I2CTrace *trace);
     /**@}*/
 
     // Note: Experimentation with inverting the sensor's axis has led to some odd
@@ -444,25 +762,107 @@ class RevEng_PAJ7620
     void invertXAxis();             // Invert (toggle) sensor's X (vertical) axis
     void invertYAxis();             // Invert (toggle) sensors' Y (vertical) axis
 
+    /** @name Orientation interface */
+    /**@{*/
+    uint8_t setOrientation(uint16_t degrees, bool mirror, bool useLens = false);
+    void orientCursor(int &x, int &y);          // Software transform, no I2C
+    Gesture orientGesture(Gesture gesture);     // Remap directional gestures
+    /**@}*/
+
     // void setGameMode(); // No documentation for this mode is available (yet)
 
     /** @name Gesture mode interface */
     /**@{*/
     Gesture readGesture();
+    Gesture readGesture(uint8_t &activity);     // One burst of 0x43..0x45, also reports activity
     void clearGestureInterrupts();
 
     void setGestureEntryTime(unsigned long newGestureEntryTime);
     void setGestureExitTime(unsigned long newGestureExitTime);
+    void setAdaptiveTiming(PAJ7620_AdaptiveTiming *timing);   // NULL: fixed entry/exit times
 
     int getWaveCount();
     /**@}*/
 
+    /** @name Activity interface */
+    /**@{*/
+    uint8_t readActivity();         // Cheap presence check, leaves gesture flags alone
+    /**@}*/
+
+    /** @name Object telemetry interface */
+    /**@{*/
+    uint8_t readObjectTelemetry(ObjectTelemetry &telemetry);  // One burst read of 0xAC..0xB7
+    /**@}*/
+
+    /** @name Proximity calibration interface */
+    /**@{*/
+    uint8_t calibrateProximity(ProximityCalibration &cal, uint8_t samples = 32,
+                               unsigned long sampleIntervalMs = 10);
+    uint8_t applyProximityCalibration(const ProximityCalibration &cal);
+    /**@}*/
+
+    /** @name Health monitor interface */
+    /**@{*/
+    void setHealthCheckInterval(unsigned long intervalMs);  // 0: off (default)
+    uint8_t checkHealth();          // Check now, re-initialize after a sensor reset
+    void getHealthStats(HealthStats &stats);
+    void clearHealthStats();
+    /**@}*/
+
+    /** @name Unified poll interface */
+    /**@{*/
+    uint8_t poll(SensorSnapshot &snap);     // Two bursts: gesture, cursor, state, object
+    void setSnapshotReads(bool enable);     // Getters return the last poll() values
+    /**@}*/
+
+    /** @name Gesture latency trace interface */
+    /**@{*/
+    void notifyInterrupt();         // Call from the INT pin ISR to timestamp the edge
+    void enableGestureTrace(GestureTraceEntry buffer[], uint8_t depth);
+    void disableGestureTrace();
+    void clearGestureTrace();
+    void printGestureTrace(Print &out);
+    /**@}*/
+
+    /** @name Time source interface */
+    /**@{*/
+    void setClockSource(PAJ7620_Clock *clock);  // NULL: Arduino micros()/millis()/delay()
+    PAJ7620_Clock *getClockSource();
+    /**@}*/
+
+    /** @name Thread-safe mode interface */
+    /**@{*/
+    void setLock(PAJ7620_Lock *lock);   // Serialize all bus sequences (NULL: off)
+
+  #if defined(ARDUINO_ARCH_ESP32)
+    bool startSensorTask(unsigned long pollPeriodMs, UBaseType_t priority = 1,
+                         uint8_t queueDepth = 8);
+    void stopSensorTask();
+    bool receiveGesture(Gesture &gesture, unsigned long timeoutMs);
+  #endif
+    /**@}*/
+
     /** @name Cursor mode interface */
     /**@{*/
     bool isCursorInView();          // Cursor object in view
 
     int getCursorX();               // Get cursor's X axis location
     int getCursorY();               // Get cusors's Y axis location
+
+    uint8_t applyCursorConfig(const CursorConfig &config);  // Kept across setCursorMode()
+    void getCursorConfig(CursorConfig &config);
+
+    uint8_t startCursorSession();   // Cursor mode driven by the INT pin via notifyInterrupt()
+    void stopCursorSession();
+    CursorEvent serviceCursorSession(int &x, int &y);   // No I2C while nothing is in view
+    /**@}*/
+
+    /** @name Register snapshot interface */
+    /**@{*/
+    uint8_t snapshot(RegisterSnapshot &snap);           // Burst read writable registers
+    uint8_t restore(const RegisterSnapshot &snap);      // Burst write them back
+    void printSnapshot(Print &out, const RegisterSnapshot &snap);
+    void printRegisters(Print &out);                    // Dump all of bank 0 and bank 1
     /**@}*/
 
 
@@ -471,21 +871,116 @@ class RevEng_PAJ7620
     unsigned long gestureExitTime;  // User set gesture exit delay in ms (default 200)
 
     TwoWire *wireHandle;            // User selected Wire bus (default: Wire)
+    uint32_t busClock;              // Hz the driver set on wireHandle (0: not set)
+    bool cursorModeActive;          // Last mode table fully written was cursor mode
+
+    CursorConfig cursorConfig;                          // Applied on entering cursor mode
+    uint8_t cursorRegisters[PAJ7620_CURSOR_CONFIG_SIZE]; // Values last written to the sensor
+    bool cursorRegistersKnown;                          // False: cursorRegisters may be stale
+
+    SensorSnapshot lastSnapshot;    // Filled by poll()
+    bool snapshotReads;             // Getters answer from lastSnapshot
+
+    ProximityCalibration psCalibration;     // Last applied, re-applied after a reset
+    bool sensorDisabled;                    // disable() in effect
+
+    uint8_t selectedBank;           // Bank the last bank select write chose
+    uint8_t canaryValue;            // Last value written to the canary register
+    unsigned long healthInterval;   // ms between automatic checks (0: off)
+    unsigned long lastHealthCheck;  // millis() of the last check
+    HealthStats healthStats;
+
+    uint8_t lensRegister;           // Cached bank 1 lens orientation (0x04) value
+    uint8_t lensFlip;               // User X/Y invert bits applied over the mode tables' value
+    uint8_t quarterTurns;           // Software rotation, clockwise 90 degree steps (0..3)
+    bool mirrorX;                   // Software mirror of X, applied before rotation
+
+    volatile unsigned long interruptTime;   // micros() of last INT edge (0: none)
+    volatile bool interruptPending;         // INT edge not yet handled by a cursor session
+    bool cursorSession;                     // startCursorSession() in effect
+    bool cursorPresent;                     // Session's object in view state
+    GestureTraceEntry *traceBuffer;         // User supplied trace ring (NULL: off)
+    uint8_t traceDepth;                     // Entries in traceBuffer
+    uint8_t traceHead;                      // Slot being filled
+    uint8_t traceCount;                     // Entries recorded, up to traceDepth
+
+    PAJ7620_Lock *lockHandle;               // Held around bus sequences (NULL: off)
+    PAJ7620_Clock *clockHandle;             // Time source for all delays and timestamps
+
+    const unsigned short *uploadArray;      // Table queued for serviceBus() (NULL: none)
+    int uploadSize;                         // Entries in uploadArray
+    int uploadIndex;                        // Next entry to write
+    uint8_t uploadBank;                     // Bank the table has selected so far
+
+    PAJ7620_I2CTrace *i2cTrace;             // Records or replays transactions (NULL: off)
+    PAJ7620_AdaptiveTiming *adaptiveTiming; // Learned entry/exit windows (NULL: fixed times)
+    uint8_t burstUploads;                   // PAJ7620_BURST_* mode of table uploads
+    bool burstVerified;                     // A verified run read back as written
+
+  #if defined(ARDUINO_ARCH_ESP32)
+    PAJ7620_FreeRTOSLock *taskLock;         // Created by startSensorTask() if no lock set
+    volatile TaskHandle_t sensorTask;       // Owned polling task (NULL: not running)
+    QueueHandle_t gestureQueue;             // Gestures published by sensorTask
+    unsigned long sensorTaskPeriod;         // ms between polls in sensorTask
+    volatile bool sensorTaskStop;           // Asks sensorTask to end itself
+
+    static void sensorTaskLoop(void *driver);
+  #endif
 
     uint8_t writeRegister(uint8_t i2cAddress, uint8_t dataByte);
     uint8_t readRegister(uint8_t i2cAddress, uint8_t byteCount, uint8_t data[]);
+    uint8_t writeRegisters(uint8_t i2cAddress, uint8_t byteCount, const uint8_t data[]);
+    uint8_t writeRegisterRun(uint8_t i2cAddress, uint8_t byteCount, const uint8_t data[]);
 
     void selectRegisterBank(Bank_e bank);
 
+    void printRegisterLine(Print &out, uint8_t bank, uint8_t i2cAddress,
+                           uint8_t byteCount, const uint8_t data[]);
+
     uint8_t getGesturesReg0(uint8_t data[]);
     uint8_t getGesturesReg1(uint8_t data[]);
 
-    Gesture forwardBackwardGestureCheck(Gesture initialGesture);
+    Gesture forwardBackwardGestureCheck(Gesture initialGesture, PAJ7620_Lock *held);
+    Gesture adaptiveEntryCheck(Gesture initialGesture, PAJ7620_Lock *held);
+    void exitWait(Gesture gesture, PAJ7620_Lock *held);
+    Gesture decodeGestureFlags(uint8_t flags0, uint8_t flags1);
+    Gesture completeGesture(uint8_t flags0, uint8_t flags1, PAJ7620_Lock *held);
+    void decodeObjectTelemetry(const uint8_t data[], ObjectTelemetry &telemetry);
+
+    void delayUnlocked(PAJ7620_Lock *held, unsigned long ms);
+
+    void modeChanged(bool cursorMode);
+    bool findTableValue(const unsigned short array[], int arraySize,
+                        uint8_t bank, uint8_t i2cAddress, uint8_t &value);
+    bool findSnapshotValue(const RegisterSnapshot &snap,
+                           uint8_t bank, uint8_t i2cAddress, uint8_t &value);
+    uint8_t writeLens(uint8_t value);
+    uint8_t readCursor(int &x, int &y);
+    void decodeCursor(const uint8_t data[], int &x, int &y);
+
+    void noteWrite(uint8_t i2cAddress, uint8_t byteCount, const uint8_t data[]);
+    void healthCheckIfDue();
+    uint8_t runHealthCheck();
+    uint8_t reinitialize();
+
+    uint8_t sampleAmbient(uint8_t samples, unsigned long sampleIntervalMs,
+                          uint8_t &mean, uint8_t &noise, PAJ7620_Lock *held);
+    void encodeCursorConfig(const CursorConfig &config, uint8_t regs[]);
+    uint8_t writeCursorRegisters(const uint8_t regs[]);
+
+    void traceStamp(GestureTraceStage stage);
+    void traceFinish(Gesture result);
 
     bool isPAJ7620UDevice();
+    void setBusClock(uint32_t hz);
+    uint8_t busRoundTrips(uint8_t rounds);
     void initializeDeviceSettings();
 
+    uint16_t readTableWord(const unsigned short array[], int index);
     void writeRegisterArray(const unsigned short array[], int arraySize);
+    int writeTableRun(const unsigned short array[], int arraySize, int index);
+    void verifyTableRun(uint8_t i2cAddress, uint8_t byteCount, const uint8_t values[]);
+    void settleBurstUploads();
 };
 
 #endif
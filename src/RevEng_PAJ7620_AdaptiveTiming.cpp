@@ -0,0 +1,266 @@
+/**
+  \file RevEng_PAJ7620_AdaptiveTiming.cpp
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+*/
+
+#include "RevEng_PAJ7620_AdaptiveTiming.h"
+
+/** Starting exit window - the driver's fixed default */
+#define PAJ7620_TIMING_EXIT_START         200
+
+
+/**
+ * Adaptive timing constructor
+ * \param minMs : shortest window
+ * \param maxMs : longest window, and the horizon for late follow-ups
+ * \param targetPercent : false positive rate windows may shrink down to
+ */
+PAJ7620_AdaptiveTiming::PAJ7620_AdaptiveTiming(uint16_t minMs, uint16_t maxMs,
+                                               uint8_t targetPercent)
+{
+  minWindow = minMs;
+  maxWindow = (maxMs > minMs) ? maxMs : minMs;
+  if (targetPercent > 100)
+    { targetPercent = 100; }
+  targetRate = (uint16_t)targetPercent * 1024 / 100;
+  reset();
+}
+
+
+/**
+ * Maps a gesture to the window that follows it
+ * \param gesture : gesture flagged by the sensor
+ * \return uint8_t : PAJ7620_TIMING_* window index, #PAJ7620_TIMING_NONE if none
+ */
+uint8_t PAJ7620_AdaptiveTiming::windowOf(Gesture gesture)
+{
+  switch (gesture)
+  {
+    case GES_LEFT:
+    case GES_RIGHT:     return PAJ7620_TIMING_ENTRY_HORIZONTAL;
+    case GES_UP:
+    case GES_DOWN:      return PAJ7620_TIMING_ENTRY_VERTICAL;
+    case GES_FORWARD:   return PAJ7620_TIMING_EXIT_FORWARD;
+    case GES_BACKWARD:  return PAJ7620_TIMING_EXIT_BACKWARD;
+    default:            return PAJ7620_TIMING_NONE;
+  }
+}
+
+
+/**
+ * Gets the current window for a gesture
+ * \param gesture : gesture flagged by the sensor
+ * \return uint16_t : entry window for directional gestures, exit window for
+ *   forward/backward, 0 for the others
+ */
+uint16_t PAJ7620_AdaptiveTiming::window(Gesture gesture)
+{
+  uint8_t index = windowOf(gesture);
+  return (index == PAJ7620_TIMING_NONE) ? 0 : windows[index];
+}
+
+
+/**
+ * Records a gesture flagged outside any window
+ *
+ * \par
+ * Settles the last window that closed empty: a forward/backward within
+ * #PAJ7620_TIMING_MAX_MS (the horizon) of the window closing is a miss, anything else (Ex: a left swipe right after forward)
+ * a clean result. Call with GES_NONE on idle polls
+ * so expired windows are settled promptly.
+ * \param gesture : gesture flagged, or GES_NONE
+ * \param nowMs : time of the flag read
+ * \return none
+ */
+void PAJ7620_AdaptiveTiming::flagged(Gesture gesture, unsigned long nowMs)
+{
+  if (pendingWindow == PAJ7620_TIMING_NONE)
+    { return; }
+
+  if (nowMs - pendingClose > maxWindow)
+  {
+    outcome(pendingWindow, false, 0);
+    pendingWindow = PAJ7620_TIMING_NONE;
+    return;
+  }
+  if (gesture == GES_NONE)
+    { return; }
+
+  // Only approach / withdrawal flags are misses: a quick deliberate swipe
+  //  after forward is a new gesture, not the hand leaving
+  bool followUp = (gesture == GES_FORWARD || gesture == GES_BACKWARD);
+  outcome(pendingWindow, followUp, followUp ? nowMs - pendingStart : 0);
+  pendingWindow = PAJ7620_TIMING_NONE;
+}
+
+
+/**
+ * Records a follow-up flagged while the window was open
+ * \param trigger : gesture that opened the window
+ * \param delayMs : time from the trigger to the follow-up
+ * \return none
+ */
+void PAJ7620_AdaptiveTiming::caught(Gesture trigger, unsigned long delayMs)
+{
+  uint8_t index = windowOf(trigger);
+  if (index != PAJ7620_TIMING_NONE)
+    { outcome(index, false, delayMs); }
+}
+
+
+/**
+ * Records a window that closed with nothing flagged
+ *
+ * \par
+ * The result is only known once the next flag arrives or the horizon
+ * passes, see flagged().
+ * \param trigger : gesture that opened the window
+ * \param startMs : time the window opened
+ * \param closeMs : time the window closed, the horizon starts there
+ * \return none
+ */
+void PAJ7620_AdaptiveTiming::passed(Gesture trigger, unsigned long startMs,
+                                    unsigned long closeMs)
+{
+  uint8_t index = windowOf(trigger);
+  if (index == PAJ7620_TIMING_NONE)
+    { return; }
+  if (pendingWindow != PAJ7620_TIMING_NONE)
+    { outcome(pendingWindow, false, 0); }   // Superseded, nothing followed it
+  pendingWindow = index;
+  pendingStart = startMs;
+  pendingClose = closeMs;
+}
+
+
+/**
+ * Adjusts a window after one result
+ * \param index : PAJ7620_TIMING_* window index
+ * \param falsePositive : True if a follow-up came after the window closed
+ * \param delayMs : time from the trigger to the follow-up, 0 if none
+ * \return none
+ */
+void PAJ7620_AdaptiveTiming::outcome(uint8_t index, bool falsePositive, unsigned long delayMs)
+{
+  uint16_t delay = clampWindow(delayMs);
+  uint16_t &window = windows[index];
+  uint16_t &peak = peaks[index];
+
+  // Rate: exponential average over roughly the last 16 results
+  rates[index] -= (rates[index] + 15) >> 4;     // Rounded up so it can reach 0
+  if (falsePositive)
+    { rates[index] += 1024 >> 4; }
+
+  if (delayMs)
+  {
+    if (delay > peak)
+      { peak = delay; }
+  }
+  else
+    { peak -= (peak + 31) >> 5; }   // Let old slow follow-ups fade
+
+  unsigned long next = window;
+  if (falsePositive)
+    { next = window + (window >> 1) + PAJ7620_TIMING_SLICE_MS; }
+  else if (rates[index] <= targetRate)
+    { next = window - (window >> 4); }
+
+  unsigned long floor = (unsigned long)peak + (peak >> 2);
+  if (next < floor)
+    { next = floor; }
+  window = clampWindow(next);
+}
+
+
+/**
+ * Limits a window to the configured bounds
+ * \param ms : window wanted
+ * \return uint16_t : ms within minMs..maxMs
+ */
+uint16_t PAJ7620_AdaptiveTiming::clampWindow(unsigned long ms)
+{
+  if (ms < minWindow)
+    { return minWindow; }
+  if (ms > maxWindow)
+    { return maxWindow; }
+  return ms;
+}
+
+
+/**
+ * Gets the recent false positive rate of a gesture's window
+ * \param gesture : gesture that opens the window
+ * \return uint8_t : percent, 0 for gestures without a window
+ */
+uint8_t PAJ7620_AdaptiveTiming::falsePositiveRate(Gesture gesture)
+{
+  uint8_t index = windowOf(gesture);
+  if (index == PAJ7620_TIMING_NONE)
+    { return 0; }
+  return ((unsigned long)rates[index] * 100 + 512) / 1024;
+}
+
+
+/**
+ * Gets the learned windows, to persist them
+ * \param timing : \link GestureTiming \endlink to fill
+ * \return none
+ */
+void PAJ7620_AdaptiveTiming::getTiming(GestureTiming &timing)
+{
+  timing.marker = PAJ7620_TIMING_MARKER;
+  timing.entryHorizontal = windows[PAJ7620_TIMING_ENTRY_HORIZONTAL];
+  timing.entryVertical = windows[PAJ7620_TIMING_ENTRY_VERTICAL];
+  timing.exitForward = windows[PAJ7620_TIMING_EXIT_FORWARD];
+  timing.exitBackward = windows[PAJ7620_TIMING_EXIT_BACKWARD];
+}
+
+
+/**
+ * Restores persisted windows, learning continues from them
+ * \note Values are clamped to this object's bounds
+ * \param timing : \link GestureTiming \endlink from getTiming()
+ * \return error code: 0 (false) if the marker is missing; success: return 1 (true)
+ */
+uint8_t PAJ7620_AdaptiveTiming::setTiming(const GestureTiming &timing)
+{
+  if (timing.marker != PAJ7620_TIMING_MARKER)
+    { return 0; }
+
+  windows[PAJ7620_TIMING_ENTRY_HORIZONTAL] = clampWindow(timing.entryHorizontal);
+  windows[PAJ7620_TIMING_ENTRY_VERTICAL] = clampWindow(timing.entryVertical);
+  windows[PAJ7620_TIMING_EXIT_FORWARD] = clampWindow(timing.exitForward);
+  windows[PAJ7620_TIMING_EXIT_BACKWARD] = clampWindow(timing.exitBackward);
+  for (uint8_t i = 0; i < PAJ7620_TIMING_WINDOWS; i++)
+  {
+    peaks[i] = 0;
+    rates[i] = 0;
+  }
+  pendingWindow = PAJ7620_TIMING_NONE;
+  return 1;
+}
+
+
+/**
+ * Starts learning over: entry windows at the minimum, exit windows at 200ms
+ * \param none
+ * \return none
+ */
+void PAJ7620_AdaptiveTiming::reset()
+{
+  for (uint8_t i = 0; i < PAJ7620_TIMING_WINDOWS; i++)
+  {
+    windows[i] = clampWindow((i < PAJ7620_TIMING_EXIT_FORWARD) ? 0 : PAJ7620_TIMING_EXIT_START);
+    peaks[i] = 0;
+    rates[i] = 0;
+  }
+  pendingWindow = PAJ7620_TIMING_NONE;
+  pendingStart = 0;
+  pendingClose = 0;
+}
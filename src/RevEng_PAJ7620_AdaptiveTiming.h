@@ -0,0 +1,116 @@
+/**
+  \file RevEng_PAJ7620_AdaptiveTiming.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Adaptive gesture entry/exit timing: learns how long the forward/backward
+  disambiguation really needs to wait for the person using the sensor.
+*/
+
+#ifndef __PAJ7620_ADAPTIVE_TIMING_H__
+#define __PAJ7620_ADAPTIVE_TIMING_H__
+
+#include "RevEng_PAJ7620.h"
+
+/** @name Adaptive timing defaults */
+/**@{*/
+/** Shortest window in ms */
+#define PAJ7620_TIMING_MIN_MS             20
+/** Longest window in ms, also how long a late follow-up is still counted as a miss */
+#define PAJ7620_TIMING_MAX_MS             400
+/** Share of gestures allowed to be false positives before windows stop shrinking */
+#define PAJ7620_TIMING_TARGET_PERCENT     5
+/** ms between flag reads while a window is open */
+#define PAJ7620_TIMING_SLICE_MS           10
+/** Marker of a valid \link GestureTiming \endlink */
+#define PAJ7620_TIMING_MARKER             0xA7
+/**@}*/
+
+/** @name Window indexes */
+/**@{*/
+#define PAJ7620_TIMING_ENTRY_HORIZONTAL   0     /**< After GES_LEFT / GES_RIGHT */
+#define PAJ7620_TIMING_ENTRY_VERTICAL     1     /**< After GES_UP / GES_DOWN */
+#define PAJ7620_TIMING_EXIT_FORWARD       2     /**< After GES_FORWARD */
+#define PAJ7620_TIMING_EXIT_BACKWARD      3     /**< After GES_BACKWARD */
+#define PAJ7620_TIMING_WINDOWS            4
+#define PAJ7620_TIMING_NONE               0xFF  /**< Gesture without a window */
+/**@}*/
+
+
+/**
+ * Learned windows, to persist (Ex: EEPROM) and restore with setTiming()
+ */
+struct GestureTiming {
+  uint8_t marker;               /**< #PAJ7620_TIMING_MARKER when valid */
+  uint16_t entryHorizontal;     /**< ms to watch for forward/backward after left/right */
+  uint16_t entryVertical;       /**< ms to watch for forward/backward after up/down */
+  uint16_t exitForward;         /**< ms of withdrawal ignored after forward */
+  uint16_t exitBackward;        /**< ms of withdrawal ignored after backward */
+};
+
+
+/**
+ * Per gesture class entry & exit windows tuned from what the sensor reports
+ *
+ * \par
+ * An entry window opens after a directional flag: if forward or backward is
+ * flagged inside it the hand was approaching or withdrawing and that is
+ * returned instead. An exit window opens after forward or backward: flags
+ * inside it are the hand withdrawing and are dropped. The driver reads the
+ * flags every #PAJ7620_TIMING_SLICE_MS while a window is open and reports:
+ * - a follow-up inside the window (caught): the window stays above the
+ *   slowest follow-up seen, with a 25% margin
+ * - a follow-up within #PAJ7620_TIMING_MAX_MS after the window closed
+ *   (missed, a false positive): the window grows by half
+ * - nothing (clean): while the false positive rate is at or under target,
+ *   the window shrinks by 1/16
+ *
+ * \par
+ * Fast movers end up with short windows and low latency, slow movers keep
+ * long ones. Integer math only, under 40 bytes of RAM.
+ * \see RevEng_PAJ7620::setAdaptiveTiming()
+ */
+class PAJ7620_AdaptiveTiming
+{
+  public:
+    PAJ7620_AdaptiveTiming(uint16_t minMs = PAJ7620_TIMING_MIN_MS,
+                           uint16_t maxMs = PAJ7620_TIMING_MAX_MS,
+                           uint8_t targetPercent = PAJ7620_TIMING_TARGET_PERCENT);
+
+    static uint8_t windowOf(Gesture gesture);   // PAJ7620_TIMING_* index
+    uint16_t window(Gesture gesture);           // ms, 0 if the gesture has none
+
+    void flagged(Gesture gesture, unsigned long nowMs);  // Flag seen outside a window
+    void caught(Gesture trigger, unsigned long delayMs); // Follow-up inside the window
+    void passed(Gesture trigger, unsigned long startMs,  // Window closed empty
+                unsigned long closeMs);
+
+    uint8_t falsePositiveRate(Gesture gesture); // Percent, recent gestures weighted most
+
+    void getTiming(GestureTiming &timing);
+    uint8_t setTiming(const GestureTiming &timing);
+    void reset();
+
+  private:
+    uint16_t minWindow;
+    uint16_t maxWindow;
+    uint16_t targetRate;                        // Q10 (1024 = 100%)
+
+    uint16_t windows[PAJ7620_TIMING_WINDOWS];   // Current window, ms
+    uint16_t peaks[PAJ7620_TIMING_WINDOWS];     // Slowest recent follow-up, ms
+    uint16_t rates[PAJ7620_TIMING_WINDOWS];     // False positive rate, Q10
+
+    uint8_t pendingWindow;                      // Closed empty, watching for a late follow-up
+    unsigned long pendingStart;                 // Trigger time, follow-up delays count from it
+    unsigned long pendingClose;                 // Close time, the miss horizon counts from it
+
+    void outcome(uint8_t index, bool falsePositive, unsigned long delayMs);
+    uint16_t clampWindow(unsigned long ms);
+};
+
+#endif
@@ -0,0 +1,183 @@
+/**
+  \file RevEng_PAJ7620_BusScheduler.cpp
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+*/
+
+#include "RevEng_PAJ7620_BusScheduler.h"
+
+
+/**
+ * Creates an empty scheduler
+ */
+PAJ7620_BusScheduler::PAJ7620_BusScheduler()
+{
+  clientCount = 0;
+  lastServed = 0;
+  clock = &PAJ7620_ArduinoClock::shared;
+  statsStart = clock->nowMicros();
+}
+
+
+/**
+ * Registers a bus client
+ * \param slice : \link PAJ7620_BusSlice \endlink doing one bounded piece of work
+ * \param context : pointer passed back to slice (Ex: &sensor)
+ * \param priority : higher values are served first
+ * \return int8_t : client ID for the other calls, -1 if the scheduler is full
+ */
+int8_t PAJ7620_BusScheduler::addClient(PAJ7620_BusSlice slice, void *context, uint8_t priority)
+{
+  if (clientCount >= PAJ7620_BUS_MAX_CLIENTS || slice == NULL)
+    { return -1; }
+
+  Client &client = clients[clientCount];
+  client.slice = slice;
+  client.context = context;
+  client.priority = priority;
+  client.pending = false;
+  client.busyMicros = 0;
+  return clientCount++;
+}
+
+
+/**
+ * Marks a client as having bus work to do
+ * \param clientId : ID returned by addClient()
+ * \return none
+ */
+void PAJ7620_BusScheduler::request(int8_t clientId)
+{
+  if (clientId >= 0 && clientId < clientCount)
+    { clients[clientId].pending = true; }
+}
+
+
+/**
+ * Returns whether a client still has bus work to do
+ * \param clientId : ID returned by addClient()
+ * \return bool : True if work is pending
+ */
+bool PAJ7620_BusScheduler::isPending(int8_t clientId)
+{
+  return clientId >= 0 && clientId < clientCount && clients[clientId].pending;
+}
+
+
+/**
+ * Picks the highest priority pending client, round robin among equals
+ * \return int8_t : client ID, -1 if nothing is pending
+ */
+int8_t PAJ7620_BusScheduler::nextClient()
+{
+  int8_t best = -1;
+  for (uint8_t i = 1; i <= clientCount; i++)
+  {
+    uint8_t id = (lastServed + i) % clientCount;
+    if (clients[id].pending &&
+        (best < 0 || clients[id].priority > clients[best].priority))
+      { best = id; }
+  }
+  return best;
+}
+
+
+/**
+ * Runs client slices until the budget is used or no work is pending
+ *
+ * \par
+ * Call this from loop(). Each slice gets whatever is left of the budget,
+ * so a slice that overruns only delays the next run() call, never another
+ * slice in this one. At least one slice runs per call so work always progresses.
+ * \param budgetUs : microseconds of bus time to hand out
+ * \return bool : True if any client still has work pending
+ */
+bool PAJ7620_BusScheduler::run(unsigned long budgetUs)
+{
+  unsigned long start = clock->nowMicros();
+  unsigned long elapsed = 0;
+
+  do
+  {
+    int8_t id = nextClient();
+    if (id < 0)
+      { return false; }
+
+    Client &client = clients[id];
+    unsigned long sliceStart = clock->nowMicros();
+    client.pending = client.slice(client.context, budgetUs - elapsed);
+    client.busyMicros += clock->nowMicros() - sliceStart;
+    lastServed = id;
+
+    elapsed = clock->nowMicros() - start;
+  } while (elapsed < budgetUs);
+
+  return nextClient() >= 0;
+}
+
+
+/**
+ * Bus time used by a client since the last resetStats()
+ * \param clientId : ID returned by addClient()
+ * \return unsigned long : microseconds spent in the client's slices
+ */
+unsigned long PAJ7620_BusScheduler::busyMicros(int8_t clientId)
+{
+  if (clientId < 0 || clientId >= clientCount)
+    { return 0; }
+  return clients[clientId].busyMicros;
+}
+
+
+/**
+ * Share of wall time a client has spent on the bus since the last resetStats()
+ * \param clientId : ID returned by addClient()
+ * \return uint8_t : utilization in percent (0..100)
+ */
+uint8_t PAJ7620_BusScheduler::utilization(int8_t clientId)
+{
+  unsigned long window = clock->nowMicros() - statsStart;
+  if (window == 0)
+    { return 0; }
+  unsigned long busy = busyMicros(clientId);
+  if (busy >= window)
+    { return 100; }
+  // Integer math only - halve both until busy * 100 fits in 32 bits
+  while (busy > 0xFFFFFFFFUL / 100)
+  {
+    busy >>= 1;
+    window >>= 1;
+  }
+  return (uint8_t)((busy * 100UL) / window);
+}
+
+
+/**
+ * Restarts the utilization measurement window for all clients
+ * \param none
+ * \return none
+ */
+void PAJ7620_BusScheduler::resetStats()
+{
+  for (uint8_t i = 0; i < clientCount; i++)
+    { clients[i].busyMicros = 0; }
+  statsStart = clock->nowMicros();
+}
+
+
+/**
+ * Sets the time source for slice budgets and utilization
+ * \note Restarts the utilization window
+ * \param clock : \link PAJ7620_Clock \endlink to use, NULL for the Arduino core
+ * \return none
+ */
+void PAJ7620_BusScheduler::setClockSource(PAJ7620_Clock *clock)
+{
+  this->clock = clock ? clock : &PAJ7620_ArduinoClock::shared;
+  resetStats();
+}
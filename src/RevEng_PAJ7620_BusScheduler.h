@@ -0,0 +1,78 @@
+/**
+  \file RevEng_PAJ7620_BusScheduler.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Cooperative scheduler for sharing one I2C (TwoWire) bus between drivers.
+  Each client does its bus work in short slices, and the scheduler hands
+  out a time budget to the highest priority client with work pending.
+*/
+
+#ifndef __PAJ7620_BUS_SCHEDULER_H__
+#define __PAJ7620_BUS_SCHEDULER_H__
+
+#include <Arduino.h>
+#include "RevEng_PAJ7620_Clock.h"
+
+/** Maximum quantity of clients registered with one scheduler */
+#define PAJ7620_BUS_MAX_CLIENTS           4
+
+/**
+ * Slice function run by the scheduler for a client
+ * \param context : pointer given to addClient() (Ex: the driver object)
+ * \param budgetUs : microseconds the slice should try to stay within
+ * \return bool : True if the client still has work pending
+ */
+typedef bool (*PAJ7620_BusSlice)(void *context, unsigned long budgetUs);
+
+
+/**
+ * Priority based cooperative bus scheduler
+ *
+ * \par
+ * Long operations like register table uploads are split into bounded
+ * slices so latency critical traffic of other drivers (Ex: a display
+ * refresh) gets the bus in between. Higher priority values run first and
+ * clients of equal priority take turns.
+ */
+class PAJ7620_BusScheduler
+{
+  public:
+    PAJ7620_BusScheduler();
+
+    int8_t addClient(PAJ7620_BusSlice slice, void *context, uint8_t priority);
+    void request(int8_t clientId);              // Client has work to do
+    bool isPending(int8_t clientId);
+
+    bool run(unsigned long budgetUs);           // Run slices for up to budgetUs
+
+    unsigned long busyMicros(int8_t clientId);  // Bus time used since resetStats()
+    uint8_t utilization(int8_t clientId);       // Percent of elapsed time on the bus
+    void resetStats();
+
+    void setClockSource(PAJ7620_Clock *clock);  // NULL: Arduino micros()
+
+  private:
+    struct Client {
+      PAJ7620_BusSlice slice;
+      void *context;
+      uint8_t priority;
+      bool pending;
+      unsigned long busyMicros;
+    };
+
+    Client clients[PAJ7620_BUS_MAX_CLIENTS];
+    uint8_t clientCount;
+    uint8_t lastServed;                         // For round robin among equals
+    unsigned long statsStart;                   // micros() at resetStats()
+    PAJ7620_Clock *clock;                       // Times slices and stats
+
+    int8_t nextClient();
+};
+
+#endif
@@ -0,0 +1,14 @@
+/**
+  \file RevEng_PAJ7620_Clock.cpp
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+*/
+
+#include "RevEng_PAJ7620_Clock.h"
+
+PAJ7620_ArduinoClock PAJ7620_ArduinoClock::shared;
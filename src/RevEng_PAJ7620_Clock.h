@@ -0,0 +1,106 @@
+/**
+  \file RevEng_PAJ7620_Clock.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Time sources used by the RevEng_PAJ7620 driver and its helpers. All
+  delays and timestamps go through a PAJ7620_Clock, so host tests can swap
+  in a simulated clock and check entry/exit timing without really waiting.
+*/
+
+#ifndef __PAJ7620_CLOCK_H__
+#define __PAJ7620_CLOCK_H__
+
+#include <Arduino.h>
+
+
+/**
+ * Clock interface: read the time, and sleep
+ * \note The micros and millis counters wrap independently, like the
+ *   Arduino ones - compare them by subtraction
+ * \see RevEng_PAJ7620::setClockSource()
+ */
+class PAJ7620_Clock
+{
+  public:
+    virtual ~PAJ7620_Clock() {}
+    virtual unsigned long nowMicros() = 0;
+    virtual unsigned long nowMillis() = 0;
+    virtual void sleepMicros(unsigned long us) = 0;
+    virtual void sleepMillis(unsigned long ms) = 0;
+};
+
+
+/**
+ * Arduino core clock: micros(), millis(), delayMicroseconds(), delay()
+ * \note The default time source - use the shared instance
+ */
+class PAJ7620_ArduinoClock : public PAJ7620_Clock
+{
+  public:
+    unsigned long nowMicros() { return micros(); }
+    unsigned long nowMillis() { return millis(); }
+    void sleepMicros(unsigned long us)
+    {
+      if (us >= 1000)
+        { delay(us / 1000); }     // delayMicroseconds() is only accurate to ~16ms
+      delayMicroseconds(us % 1000);
+    }
+    void sleepMillis(unsigned long ms) { delay(ms); }
+
+    static PAJ7620_ArduinoClock shared;     // Used when no clock is set
+};
+
+
+/**
+ * Simulated clock for host builds and tests
+ *
+ * \par
+ * Time only moves when sleep*() or advance() is called, so a test can run
+ * thousands of timed gesture scenarios in milliseconds and assert the exact
+ * time the driver waited.
+ */
+class PAJ7620_SimClock : public PAJ7620_Clock
+{
+  public:
+    PAJ7620_SimClock() : micro(0), milli(0), remainder(0), sleeps(0), slept(0) {}
+
+    unsigned long nowMicros() { return micro; }
+    unsigned long nowMillis() { return milli; }
+    void sleepMicros(unsigned long us) { sleeps++; slept += us; advance(us); }
+    void sleepMillis(unsigned long ms) { sleeps++; slept += ms * 1000UL; advanceMillis(ms); }
+
+    /** Moves time forward without counting a sleep */
+    void advance(unsigned long us)
+    {
+      micro += us;
+      remainder += us % 1000;
+      milli += us / 1000 + remainder / 1000;
+      remainder %= 1000;
+    }
+
+    /** Moves time forward in whole ms without counting a sleep */
+    void advanceMillis(unsigned long ms)
+    {
+      micro += ms * 1000UL;
+      milli += ms;
+    }
+
+    unsigned long sleepCount() { return sleeps; }     // sleep*() calls made
+    unsigned long sleptMicros() { return slept; }     // Total time slept
+    void clearSleeps() { sleeps = 0; slept = 0; }
+
+  private:
+    unsigned long micro;
+    unsigned long milli;
+    unsigned long remainder;        // us not yet counted in milli
+    unsigned long sleeps;
+    unsigned long slept;
+};
+
+#endif
@@ -0,0 +1,196 @@
+/**
+  \file RevEng_PAJ7620_Combo.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Gesture combo recognizer: spots registered gesture sequences
+  (Ex: up-up-down, clockwise-then-wave) in the stream of gestures returned
+  by readGesture(). Header only, fixed size, no heap.
+*/
+
+#ifndef __PAJ7620_COMBO_H__
+#define __PAJ7620_COMBO_H__
+
+#include "RevEng_PAJ7620.h"
+
+/** Returned by PAJ7620_ComboRecognizer::update() when no combo completed */
+#define PAJ7620_COMBO_NONE                (-1)
+
+/** Gestures a combo can be made of: GES_UP (1) through GES_WAVE (9) */
+#define PAJ7620_COMBO_SYMBOLS             9
+
+
+/**
+ * Aho-Corasick automaton over \link Gesture \endlink values
+ *
+ * \par
+ * Combos are added during setup() with addCombo() into a trie of at most
+ * MAX_NODES nodes (one per distinct combo prefix). The first update() turns
+ * the trie into a complete state machine, so every gesture after that is a
+ * single table lookup, and partial matches recover correctly: with
+ * up-up-down registered, up-up-up-down still completes it.
+ *
+ * \par
+ * Each combo gives a step window: the longest gap in ms allowed between two
+ * of its gestures. When the window runs out the partial match is dropped.
+ * Combos sharing a prefix share its nodes, and the larger window applies.
+ *
+ * \par
+ * RAM use is MAX_NODES * 13 bytes (Ex: 208 bytes for the default 16 nodes).
+ * \tparam MAX_NODES : trie nodes including the root, at most 255
+ */
+template <uint8_t MAX_NODES = 16>
+class PAJ7620_ComboRecognizer
+{
+  public:
+    PAJ7620_ComboRecognizer() : nodeCount(1), comboCount(0), built(false),
+                                current(0), lastTime(0)
+    {
+      memset(next, 0, sizeof(next));
+      memset(fail, 0, sizeof(fail));
+      memset(window, 0, sizeof(window));
+      memset(output, PAJ7620_COMBO_NONE, sizeof(output));
+    }
+
+    /**
+     * Registers a combo - call for every combo before the first update()
+     * \param steps : gestures in order, GES_UP through GES_WAVE
+     * \param length : quantity of steps (at least 1)
+     * \param stepWindowMs : longest gap allowed between two steps
+     * \return int8_t : combo ID (0, 1, ... in order added), or -1 if the
+     *   steps are invalid, the combo is already registered, there are not
+     *   enough nodes left, or update() has already been called
+     */
+    int8_t addCombo(const Gesture steps[], uint8_t length, uint16_t stepWindowMs)
+    {
+      if (built || length == 0 || comboCount >= 127)
+        { return PAJ7620_COMBO_NONE; }
+
+      // Validate and count the new nodes first so a failed add changes nothing
+      uint8_t node = 0;
+      uint8_t newNodes = 0;
+      for (uint8_t i = 0; i < length; i++)
+      {
+        if (steps[i] == GES_NONE || steps[i] > PAJ7620_COMBO_SYMBOLS)
+          { return PAJ7620_COMBO_NONE; }
+        if (newNodes == 0 && next[node][steps[i] - 1])
+          { node = next[node][steps[i] - 1]; }
+        else
+          { newNodes++; }
+      }
+      if ((newNodes == 0 && output[node] != PAJ7620_COMBO_NONE) ||
+          nodeCount + newNodes > MAX_NODES)
+        { return PAJ7620_COMBO_NONE; }
+
+      node = 0;
+      for (uint8_t i = 0; i < length; i++)
+      {
+        uint8_t symbol = steps[i] - 1;
+        if (!next[node][symbol])
+          { next[node][symbol] = nodeCount++; }
+        if (window[node] < stepWindowMs)
+          { window[node] = stepWindowMs; }
+        node = next[node][symbol];
+      }
+      output[node] = comboCount;
+      return comboCount++;
+    }
+
+    /**
+     * Feeds the next gesture, O(1) after the first call
+     * \param gesture : gesture from readGesture() - GES_NONE is ignored
+     * \param nowMs : time of the gesture (Ex: millis())
+     * \return int8_t : ID of the combo this gesture completed, or
+     *   PAJ7620_COMBO_NONE
+     */
+    int8_t update(Gesture gesture, unsigned long nowMs)
+    {
+      if (!built)
+        { build(); }
+      if (gesture == GES_NONE || gesture > PAJ7620_COMBO_SYMBOLS)
+        { return PAJ7620_COMBO_NONE; }
+
+      if (current && (nowMs - lastTime) > window[current])
+        { current = 0; }            // Took too long, start over
+      current = next[current][gesture - 1];
+      lastTime = nowMs;
+
+      int8_t combo = output[current];
+      if (combo != PAJ7620_COMBO_NONE)
+        { current = 0; }            // A gesture only counts toward one combo
+      return combo;
+    }
+
+    /**
+     * Feeds the next gesture, timed with millis()
+     * \param gesture : gesture from readGesture() - GES_NONE is ignored
+     * \return int8_t : ID of the completed combo, or PAJ7620_COMBO_NONE
+     */
+    int8_t update(Gesture gesture)
+    {
+      return update(gesture, millis());
+    }
+
+    /** Drops any partial match */
+    void reset()
+    {
+      current = 0;
+    }
+
+    /** Returns the quantity of registered combos */
+    uint8_t combos()
+    {
+      return comboCount;
+    }
+
+  private:
+    uint8_t next[MAX_NODES][PAJ7620_COMBO_SYMBOLS]; // Trie edges, then full transitions
+    uint8_t fail[MAX_NODES];        // Longest proper suffix that is also a prefix
+    uint16_t window[MAX_NODES];     // ms allowed before the step out of this node
+    int8_t output[MAX_NODES];       // Combo ending here (or at a suffix), -1 none
+    uint8_t nodeCount;
+    uint8_t comboCount;
+    bool built;
+
+    uint8_t current;                // Node of the partial match in progress
+    unsigned long lastTime;         // Time of the last gesture fed
+
+    /**
+     * Fills in fail links and the missing transitions, breadth first
+     * \note A node's row is completed when it leaves the queue, and its
+     *   fail node is shallower so that row is already complete
+     */
+    void build()
+    {
+      uint8_t queue[MAX_NODES];
+      uint8_t head = 0, tail = 0;
+      queue[tail++] = 0;
+
+      while (head < tail)
+      {
+        uint8_t node = queue[head++];
+        for (uint8_t symbol = 0; symbol < PAJ7620_COMBO_SYMBOLS; symbol++)
+        {
+          uint8_t child = next[node][symbol];
+          uint8_t fallback = node ? next[fail[node]][symbol] : 0;
+          if (child)
+          {
+            fail[child] = fallback;
+            if (output[child] == PAJ7620_COMBO_NONE)
+              { output[child] = output[fallback]; }
+            queue[tail++] = child;
+          }
+          else
+            { next[node][symbol] = fallback; }
+        }
+      }
+      built = true;
+    }
+};
+
+#endif
@@ -0,0 +1,198 @@
+/**
+  \file RevEng_PAJ7620_I2CTrace.cpp
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+*/
+
+#include "RevEng_PAJ7620_I2CTrace.h"
+
+
+/**
+ * Creates an idle trace - neither recording nor replaying
+ */
+PAJ7620_I2CTrace::PAJ7620_I2CTrace()
+{
+  recordBuffer = NULL;
+  replayBuffer = NULL;
+  size = 0;
+  used = 0;
+  recording = false;
+  replaying = false;
+  overflow = false;
+  mismatchCount = 0;
+  lastTime = 0;
+}
+
+
+/**
+ * Starts recording transactions into a caller supplied buffer
+ * \note Recording stops (and overflowed() turns true) when the buffer is full
+ * \param buffer : bytes to record into, must outlive the recording
+ * \param bufferSize : quantity of bytes in buffer
+ * \return none
+ */
+void PAJ7620_I2CTrace::beginRecording(uint8_t buffer[], size_t bufferSize)
+{
+  reset();
+  recordBuffer = buffer;
+  size = bufferSize;
+  recording = true;
+}
+
+
+/**
+ * Starts feeding a recorded trace back to the driver instead of the bus
+ * \param trace : bytes of a recorded trace (Ex: a fixture array)
+ * \param traceLength : quantity of bytes in trace
+ * \return none
+ */
+void PAJ7620_I2CTrace::beginReplay(const uint8_t trace[], size_t traceLength)
+{
+  reset();
+  replayBuffer = trace;
+  size = traceLength;
+  replaying = true;
+}
+
+
+/**
+ * Ends recording or replay
+ * \note length() and the counters keep their values until the next begin
+ * \param none
+ * \return none
+ */
+void PAJ7620_I2CTrace::stop()
+{
+  recording = false;
+  replaying = false;
+}
+
+
+/**
+ * Clears position and counters ahead of a new recording or replay
+ * \param none
+ * \return none
+ */
+void PAJ7620_I2CTrace::reset()
+{
+  stop();
+  used = 0;
+  overflow = false;
+  mismatchCount = 0;
+  lastTime = 0;
+}
+
+
+/**
+ * Appends one transaction to the recording
+ * \param isRead : True for a register read, False for a write
+ * \param i2cAddress : first register address
+ * \param byteCount : quantity of data bytes
+ * \param data : bytes written, or bytes returned by the sensor
+ * \param nowUs : micros() when the transaction completed
+ * \return none
+ */
+void PAJ7620_I2CTrace::recordTransaction(bool isRead, uint8_t i2cAddress, uint8_t byteCount,
+                                         const uint8_t data[], unsigned long nowUs)
+{
+  if (!recording || overflow)
+    { return; }
+
+  uint8_t header[2 + 5];            // Header, address and up to a 5 byte varint
+  uint8_t headerLength = 0;
+  // 32 bits on every target, even where unsigned long is 64 and the clock
+  //  stepped backwards (Ex: setClockSource() while recording)
+  uint32_t delta = (used == 0) ? 0 : (uint32_t)(nowUs - lastTime);
+  lastTime = nowUs;
+
+  header[headerLength++] = (isRead ? PAJ7620_TRACE_READ : 0) | (byteCount & PAJ7620_TRACE_LENGTH_MASK);
+  header[headerLength++] = i2cAddress;
+  do
+  {
+    uint8_t chunk = delta & 0x7F;
+    delta >>= 7;
+    header[headerLength++] = chunk | (delta ? 0x80 : 0x00);
+  } while (delta);
+
+  if (used + headerLength + byteCount > size)
+  {
+    overflow = true;
+    return;
+  }
+  memcpy(&recordBuffer[used], header, headerLength);
+  memcpy(&recordBuffer[used + headerLength], data, byteCount);
+  used += headerLength + byteCount;
+}
+
+
+/**
+ * Plays back the next transaction of the trace
+ *
+ * \par
+ * Reads are answered with the bytes recorded for them. Writes are compared
+ * against the recording. Any difference in operation, address, length, or
+ * written data counts as a mismatch, which means the driver under test has
+ * diverged from the recorded session.
+ * \param isRead : True for a register read, False for a write
+ * \param i2cAddress : first register address
+ * \param byteCount : quantity of data bytes
+ * \param data : for reads filled from the trace, for writes the bytes being written
+ * \return bool : True if the transaction matched the trace
+ */
+bool PAJ7620_I2CTrace::replayTransaction(bool isRead, uint8_t i2cAddress, uint8_t byteCount,
+                                         uint8_t data[])
+{
+  if (!replaying || used + 2 > size)
+    { mismatchCount++; return false; }
+
+  uint8_t header = replayBuffer[used];
+  uint8_t address = replayBuffer[used + 1];
+  size_t position = used + 2;
+  while (position < size && (replayBuffer[position] & 0x80))
+    { position++; }                 // Timing is not needed to replay
+  position++;
+
+  uint8_t count = header & PAJ7620_TRACE_LENGTH_MASK;
+  bool matched = ((header & PAJ7620_TRACE_READ) != 0) == isRead &&
+                 address == i2cAddress && count == byteCount &&
+                 position + count <= size;
+  if (!matched)
+    { mismatchCount++; return false; }
+
+  if (isRead)
+    { memcpy(data, &replayBuffer[position], count); }
+  else if (memcmp(data, &replayBuffer[position], count) != 0)
+    { mismatchCount++; matched = false; }
+
+  used = position + count;
+  return matched;
+}
+
+
+/**
+ * Prints the recorded trace as hex text for capture by a host
+ *
+ * \par
+ * Framed by "PAJ7620 I2C TRACE BEGIN" and "PAJ7620 I2C TRACE END" lines with
+ * 32 bytes per line in between. scripts/paj7620_i2ctrace.py decodes a capture
+ * and turns it into a fixture array for replay.
+ * \param out : Print stream to write to (Ex: Serial)
+ * \return none
+ */
+void PAJ7620_I2CTrace::print(Print &out)
+{
+  out.println("PAJ7620 I2C TRACE BEGIN");
+  for (size_t i = 0; recordBuffer && i < used; i++)
+  {
+    if (recordBuffer[i] < 0x10) { out.print('0'); }
+    out.print(recordBuffer[i], HEX);
+    if ((i % 32) == 31 || i == used - 1)
+      { out.println(); }
+  }
+  out.println("PAJ7620 I2C TRACE END");
+}
@@ -0,0 +1,74 @@
+/**
+  \file RevEng_PAJ7620_I2CTrace.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Records every register transaction made by the RevEng_PAJ7620 driver into
+  a compact binary trace, and replays a recorded trace back to the driver in
+  place of the I2C bus so field sessions become deterministic fixtures.
+
+  Trace record format (all records back to back):
+  - byte 0 : bit 7 set for a read, bits [6:0] data length (1..127)
+  - byte 1 : register address
+  - varint : 32 bit microseconds since the previous record (7 bits per byte, LSB first)
+  - data   : the bytes written, or the bytes the sensor returned for a read
+*/
+
+#ifndef __PAJ7620_I2C_TRACE_H__
+#define __PAJ7620_I2C_TRACE_H__
+
+#include <Arduino.h>
+
+/** Set in a record's first byte when the record is a read */
+#define PAJ7620_TRACE_READ                0x80
+/** Mask for the data length in a record's first byte */
+#define PAJ7620_TRACE_LENGTH_MASK         0x7F
+
+
+/**
+ * I2C transaction recorder and replayer for the PAJ7620 driver
+ * \see RevEng_PAJ7620::setI2CTrace()
+ */
+class PAJ7620_I2CTrace
+{
+  public:
+    PAJ7620_I2CTrace();
+
+    void beginRecording(uint8_t buffer[], size_t size);
+    void beginReplay(const uint8_t trace[], size_t length);
+    void stop();
+
+    bool isRecording() { return recording; }
+    bool isReplaying() { return replaying; }
+
+    void recordTransaction(bool isRead, uint8_t i2cAddress, uint8_t byteCount,
+                           const uint8_t data[], unsigned long nowUs);
+    bool replayTransaction(bool isRead, uint8_t i2cAddress, uint8_t byteCount, uint8_t data[]);
+
+    size_t length() { return used; }          // Bytes recorded or replayed so far
+    bool overflowed() { return overflow; }    // Recording ran out of buffer
+    unsigned int mismatches() { return mismatchCount; }   // Replay divergences
+    bool replayFinished() { return replaying && used >= size; }
+
+    void print(Print &out);
+
+  private:
+    uint8_t *recordBuffer;
+    const uint8_t *replayBuffer;
+    size_t size;
+    size_t used;
+    bool recording;
+    bool replaying;
+    bool overflow;
+    unsigned int mismatchCount;
+    unsigned long lastTime;
+
+    void reset();
+};
+
+#endif
@@ -0,0 +1,99 @@
+/**
+  \file RevEng_PAJ7620_Lock.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Locks used by the RevEng_PAJ7620 driver when it is shared between
+  threads or RTOS tasks. Every multi-transaction sequence in the driver
+  (bank switch, register access, bank restore) runs while holding the lock.
+*/
+
+#ifndef __PAJ7620_LOCK_H__
+#define __PAJ7620_LOCK_H__
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#endif
+
+#if defined(PAJ7620_STD_LOCK)
+#include <mutex>
+#endif
+
+
+/**
+ * Lock interface for the driver's thread-safe mode
+ * \note Implementations must be recursive: public driver calls nest
+ *   (Ex: begin() calls setGestureMode()) and take the lock each time
+ * \see RevEng_PAJ7620::setLock()
+ */
+class PAJ7620_Lock
+{
+  public:
+    virtual ~PAJ7620_Lock() {}
+    virtual void lock() = 0;        // Block until the lock is held
+    virtual void unlock() = 0;      // Release one level of the lock
+};
+
+
+/**
+ * Scoped holder for a \link PAJ7620_Lock \endlink - a NULL lock is a no-op
+ */
+class PAJ7620_LockGuard
+{
+  public:
+    explicit PAJ7620_LockGuard(PAJ7620_Lock *lock) : heldLock(lock)
+      { if (heldLock) { heldLock->lock(); } }
+    ~PAJ7620_LockGuard()
+      { if (heldLock) { heldLock->unlock(); } }
+    PAJ7620_Lock *held() { return heldLock; }  // Lock taken, for waits that release it
+
+  private:
+    PAJ7620_Lock *heldLock;
+    PAJ7620_LockGuard(const PAJ7620_LockGuard &);
+    PAJ7620_LockGuard &operator=(const PAJ7620_LockGuard &);
+};
+
+
+#if defined(ARDUINO_ARCH_ESP32)
+/**
+ * FreeRTOS recursive mutex lock for ESP32 builds
+ */
+class PAJ7620_FreeRTOSLock : public PAJ7620_Lock
+{
+  public:
+    PAJ7620_FreeRTOSLock() : mutex(xSemaphoreCreateRecursiveMutex()) {}
+    ~PAJ7620_FreeRTOSLock() { vSemaphoreDelete(mutex); }
+    void lock() { xSemaphoreTakeRecursive(mutex, portMAX_DELAY); }
+    void unlock() { xSemaphoreGiveRecursive(mutex); }
+
+  private:
+    SemaphoreHandle_t mutex;
+};
+#endif
+
+
+#if defined(PAJ7620_STD_LOCK)
+/**
+ * std::recursive_mutex lock for host builds and tests
+ * \note Enabled by defining PAJ7620_STD_LOCK before including the driver header
+ */
+class PAJ7620_StdLock : public PAJ7620_Lock
+{
+  public:
+    void lock() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+
+  private:
+    std::recursive_mutex mutex;
+};
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+/**
+  \file RevEng_PAJ7620_PollGovernor.cpp
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+*/
+
+#include "RevEng_PAJ7620_PollGovernor.h"
+
+
+/**
+ * Poll governor constructor
+ * \param minIntervalMs : interval while activity is seen
+ * \param maxIntervalMs : upper limit of the idle backoff
+ * \note The first call to pollGesture() / pollActivity() always polls
+ */
+PAJ7620_PollGovernor::PAJ7620_PollGovernor(unsigned long minIntervalMs,
+                                           unsigned long maxIntervalMs)
+{
+  minInterval = minIntervalMs ? minIntervalMs : 1;
+  maxInterval = (maxIntervalMs > minInterval) ? maxIntervalMs : minInterval;
+  currentInterval = minInterval;
+  lastPoll = 0;
+  woken = true;
+  polls = 0;
+  clock = &PAJ7620_ArduinoClock::shared;
+}
+
+
+/**
+ * Reads a gesture if a poll is due
+ *
+ * \par
+ * The gesture flags and the state indicator are read in one burst, so the
+ * poll rate ramps up as soon as a hand starts moving, before the sensor
+ * has finished recognizing the gesture, and an idle poll costs a single
+ * I2C transaction.
+ * \param sensor : initialized driver in gesture mode
+ * \return \link Gesture \endlink read, GES_NONE if none or if no poll was due
+ */
+Gesture PAJ7620_PollGovernor::pollGesture(RevEng_PAJ7620 &sensor)
+{
+  if (!isDue())
+    { return GES_NONE; }
+
+  uint8_t activity = 0;
+  Gesture result = sensor.readGesture(activity);
+  update(result != GES_NONE || activity);
+  return result;
+}
+
+
+/**
+ * Reads the activity bits if a poll is due
+ * \param sensor : initialized driver (cursor mode reports objects in view)
+ * \return uint8_t : PAJ7620_ACTIVITY_* bits, 0 if idle or if no poll was due
+ */
+uint8_t PAJ7620_PollGovernor::pollActivity(RevEng_PAJ7620 &sensor)
+{
+  if (!isDue())
+    { return 0; }
+
+  uint8_t activity = sensor.readActivity();
+  update(activity != 0);
+  return activity;
+}
+
+
+/**
+ * Returns whether the current interval has elapsed since the last poll
+ * \param none
+ * \return bool : True if the sensor should be polled now
+ */
+bool PAJ7620_PollGovernor::isDue()
+{
+  return woken || (clock->nowMillis() - lastPoll) >= currentInterval;
+}
+
+
+/**
+ * Records the outcome of a poll made by the caller
+ *
+ * \par
+ * Only needed when polling the driver directly instead of through
+ * pollGesture() / pollActivity().
+ * \param active : True if the poll saw a gesture, an object, or engine activity
+ * \return unsigned long : ms until the next poll is due
+ */
+unsigned long PAJ7620_PollGovernor::update(bool active)
+{
+  lastPoll = clock->nowMillis();
+  woken = false;
+  polls++;
+
+  if (active)
+    { currentInterval = minInterval; }
+  else if (currentInterval < maxInterval)
+  {
+    currentInterval *= 2;
+    if (currentInterval > maxInterval)
+      { currentInterval = maxInterval; }
+  }
+  return currentInterval;
+}
+
+
+/**
+ * Makes the next call poll immediately, regardless of the interval
+ *
+ * \par
+ * Safe to call from an INT pin ISR, it only sets a flag.
+ * \param none
+ * \return none
+ */
+void PAJ7620_PollGovernor::wake()
+{
+  woken = true;
+}
+
+
+/**
+ * Returns the current poll interval
+ * \param none
+ * \return unsigned long : ms between polls at the current activity level
+ */
+unsigned long PAJ7620_PollGovernor::interval()
+{
+  return currentInterval;
+}
+
+
+/**
+ * Returns how long until the next poll is due
+ * \param none
+ * \return unsigned long : ms to wait, 0 if a poll is due now
+ */
+unsigned long PAJ7620_PollGovernor::timeUntilDue()
+{
+  if (isDue())
+    { return 0; }
+  return currentInterval - (clock->nowMillis() - lastPoll);
+}
+
+
+/**
+ * Returns the quantity of polls made
+ * \param none
+ * \return unsigned long : polls recorded by update()
+ */
+unsigned long PAJ7620_PollGovernor::pollCount()
+{
+  return polls;
+}
+
+
+/**
+ * Sets the time source for poll intervals
+ * \param clock : \link PAJ7620_Clock \endlink to use (Ex: sensor.getClockSource()),
+ *   NULL for the Arduino core
+ * \return none
+ */
+void PAJ7620_PollGovernor::setClockSource(PAJ7620_Clock *clock)
+{
+  this->clock = clock ? clock : &PAJ7620_ArduinoClock::shared;
+}
@@ -0,0 +1,69 @@
+/**
+  \file RevEng_PAJ7620_PollGovernor.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Activity-adaptive polling: polls the sensor quickly while something is in
+  front of it and backs off exponentially while the scene is idle.
+*/
+
+#ifndef __PAJ7620_POLL_GOVERNOR_H__
+#define __PAJ7620_POLL_GOVERNOR_H__
+
+#include "RevEng_PAJ7620.h"
+
+/** Default poll interval in ms while active */
+#define PAJ7620_POLL_MIN_MS               20
+/** Default longest poll interval in ms while idle */
+#define PAJ7620_POLL_MAX_MS               640
+
+
+/**
+ * Decides when the sensor should next be polled
+ *
+ * \par
+ * Every poll that finds a gesture, an object, or a busy gesture engine
+ * drops the interval to the minimum; every idle poll doubles it, up to the
+ * maximum. Gesture flags stay latched in the sensor until read, so a gesture
+ * made during a long idle interval is still reported on the next poll.
+ *
+ * \par
+ * Call pollGesture() (gesture mode) or pollActivity() (cursor mode) from
+ * loop() as often as you like - the sensor is only touched when a poll is
+ * due. timeUntilDue() tells a sleeping application how long it may sleep.
+ */
+class PAJ7620_PollGovernor
+{
+  public:
+    PAJ7620_PollGovernor(unsigned long minIntervalMs = PAJ7620_POLL_MIN_MS,
+                         unsigned long maxIntervalMs = PAJ7620_POLL_MAX_MS);
+
+    Gesture pollGesture(RevEng_PAJ7620 &sensor);    // readGesture(activity) when due
+    uint8_t pollActivity(RevEng_PAJ7620 &sensor);   // readActivity() when due
+
+    bool isDue();
+    unsigned long update(bool active);  // Record a poll's outcome, returns next interval
+    void wake();                        // Poll on the next call (Ex: INT pin edge)
+
+    unsigned long interval();           // Current interval in ms
+    unsigned long timeUntilDue();       // ms until the next poll, 0 if due
+    unsigned long pollCount();          // Polls made since construction
+
+    void setClockSource(PAJ7620_Clock *clock);  // NULL: Arduino millis()
+
+  private:
+    unsigned long minInterval;
+    unsigned long maxInterval;
+    unsigned long currentInterval;
+    unsigned long lastPoll;             // millis() of the last poll
+    volatile bool woken;                // Poll on the next call regardless of time
+    unsigned long polls;
+    PAJ7620_Clock *clock;
+};
+
+#endif
@@ -0,0 +1,125 @@
+/**
+  \file RevEng_PAJ7620_Stream.cpp
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+*/
+
+#include "RevEng_PAJ7620_Stream.h"
+
+
+/**
+ * Creates a frame writer
+ * \param output : Print stream to write frames to (Ex: Serial)
+ */
+PAJ7620_Stream::PAJ7620_Stream(Print &output)
+{
+  out = &output;
+  nextSequence = 0;
+  haveLastCursor = false;
+  lastX = 0;
+  lastY = 0;
+  framesSinceKey = 0;
+}
+
+
+/**
+ * Writes a cursor sample, as a delta frame when it fits
+ * \param x : cursor X (Ex: from getCursorX())
+ * \param y : cursor Y (Ex: from getCursorY())
+ * \return none
+ */
+void PAJ7620_Stream::writeCursor(int x, int y)
+{
+  int dx = x - lastX;
+  int dy = y - lastY;
+
+  if (haveLastCursor && framesSinceKey < PAJ7620_FRAME_KEY_INTERVAL &&
+      dx >= -128 && dx <= 127 && dy >= -128 && dy <= 127)
+  {
+    uint8_t payload[2] = { (uint8_t)(int8_t)dx, (uint8_t)(int8_t)dy };
+    writeFrame(PAJ7620_FRAME_CURSOR_DELTA, payload, sizeof(payload));
+    framesSinceKey++;
+  }
+  else
+  {
+    uint8_t payload[4] = { (uint8_t)(x & 0xFF), (uint8_t)((x >> 8) & 0xFF),
+                           (uint8_t)(y & 0xFF), (uint8_t)((y >> 8) & 0xFF) };
+    writeFrame(PAJ7620_FRAME_CURSOR_KEY, payload, sizeof(payload));
+    framesSinceKey = 0;
+  }
+
+  haveLastCursor = true;
+  lastX = x;
+  lastY = y;
+}
+
+
+/**
+ * Writes a frame saying no cursor object is in view
+ * \note The next cursor sample is sent as a key frame
+ * \param none
+ * \return none
+ */
+void PAJ7620_Stream::writeNoObject()
+{
+  writeFrame(PAJ7620_FRAME_NO_OBJECT, NULL, 0);
+  haveLastCursor = false;
+}
+
+
+/**
+ * Writes a gesture event frame
+ * \param gesture : \link Gesture \endlink to send (Ex: from readGesture())
+ * \return none
+ */
+void PAJ7620_Stream::writeGesture(Gesture gesture)
+{
+  uint8_t payload[1] = { (uint8_t)gesture };
+  writeFrame(PAJ7620_FRAME_GESTURE, payload, sizeof(payload));
+}
+
+
+/**
+ * Folds one byte into a CRC-8 (polynomial 0x07)
+ * \param crc : CRC so far (start with 0x00)
+ * \param data : next byte
+ * \return uint8_t : updated CRC
+ */
+uint8_t PAJ7620_Stream::crc8(uint8_t crc, uint8_t data)
+{
+  crc ^= data;
+  for (uint8_t bit = 0; bit < 8; bit++)
+    { crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1); }
+  return crc;
+}
+
+
+/**
+ * Writes one complete frame in a single write() call
+ * \param type : PAJ7620_FRAME_* type
+ * \param payload : payload bytes
+ * \param length : quantity of payload bytes (at most 4)
+ * \return none
+ */
+void PAJ7620_Stream::writeFrame(uint8_t type, const uint8_t payload[], uint8_t length)
+{
+  uint8_t frame[4 + 4];
+  uint8_t size = 0;
+  uint8_t crc = 0;
+
+  frame[size++] = PAJ7620_FRAME_SYNC;
+  frame[size++] = type;
+  frame[size++] = nextSequence++;
+  for (uint8_t i = 0; i < length; i++)
+    { frame[size++] = payload[i]; }
+  for (uint8_t i = 1; i < size; i++)
+    { crc = crc8(crc, frame[i]); }
+  frame[size++] = crc;
+
+  out->write(frame, size);
+}
@@ -0,0 +1,79 @@
+/**
+  \file RevEng_PAJ7620_Stream.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Compact binary framing for streaming cursor samples and gesture events
+  to a host, replacing text output with Serial.print.
+
+  Frame layout (fixed size per frame type):
+  - sync     : 0xA5
+  - type     : one of the PAJ7620_FRAME_* values below
+  - sequence : rolling 8 bit frame counter, lets the host spot dropped frames
+  - payload  : 0, 1, 2 or 4 bytes depending on type
+  - checksum : CRC-8 (polynomial 0x07, init 0x00) over type, sequence and payload
+
+  Decoded on the host by scripts/paj7620_stream.py
+*/
+
+#ifndef __PAJ7620_STREAM_H__
+#define __PAJ7620_STREAM_H__
+
+#include "RevEng_PAJ7620.h"
+
+/** @name Stream frame constants */
+/**@{*/
+/** First byte of every frame */
+#define PAJ7620_FRAME_SYNC                0xA5
+/** Absolute cursor sample - payload: X low, X high, Y low, Y high */
+#define PAJ7620_FRAME_CURSOR_KEY          0x01
+/** Cursor sample relative to the previous one - payload: int8 dX, int8 dY */
+#define PAJ7620_FRAME_CURSOR_DELTA        0x02
+/** Cursor left the field of view - no payload */
+#define PAJ7620_FRAME_NO_OBJECT           0x03
+/** Gesture event - payload: \link Gesture \endlink value */
+#define PAJ7620_FRAME_GESTURE             0x04
+
+/** A key frame is forced at least this often so the host can resync */
+#define PAJ7620_FRAME_KEY_INTERVAL        32
+/**@}*/
+
+
+/**
+ * Binary frame writer for cursor and gesture output
+ *
+ * \par
+ * Cursor samples are delta encoded against the previous sample: a delta
+ * frame is 6 bytes against roughly 20 characters of text, and no string
+ * formatting happens on the microcontroller.
+ */
+class PAJ7620_Stream
+{
+  public:
+    explicit PAJ7620_Stream(Print &output);
+
+    void writeCursor(int x, int y);
+    void writeNoObject();
+    void writeGesture(Gesture gesture);
+
+    uint8_t sequence() { return nextSequence; }   // Sequence number of the next frame
+
+    static uint8_t crc8(uint8_t crc, uint8_t data);
+
+  private:
+    Print *out;
+    uint8_t nextSequence;
+    bool haveLastCursor;            // False forces the next cursor sample to a key frame
+    int lastX;
+    int lastY;
+    uint8_t framesSinceKey;
+
+    void writeFrame(uint8_t type, const uint8_t payload[], uint8_t length);
+};
+
+#endif
@@ -0,0 +1,183 @@
+/**
+  \file RevEng_PAJ7620_Swipe.cpp
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+*/
+
+#include "RevEng_PAJ7620_Swipe.h"
+
+
+/**
+ * Swipe recognizer constructor
+ * \param minDistance : cursor counts of travel along one axis
+ * \param minSpeed : average cursor counts per second
+ * \param maxDuration : ms a swipe may take, measured from its start sample
+ */
+PAJ7620_SwipeRecognizer::PAJ7620_SwipeRecognizer(uint16_t minDistance, uint16_t minSpeed,
+                                                 uint16_t maxDuration)
+{
+  this->minDistance = minDistance ? minDistance : 1;
+  this->minSpeed = minSpeed;
+  this->maxDuration = maxDuration ? maxDuration : 1;
+  reset();
+}
+
+
+/**
+ * Takes a cursor sample from the sensor and classifies it
+ * \note The sensor must be in cursor mode. Timed by the sensor's clock source
+ * \param sensor : initialized driver
+ * \return \link Gesture \endlink : the swipe recognized on this sample, or GES_NONE
+ */
+Gesture PAJ7620_SwipeRecognizer::update(RevEng_PAJ7620 &sensor)
+{
+  unsigned long now = sensor.getClockSource()->nowMillis();
+  if (!sensor.isCursorInView())
+    { return update(false, 0, 0, now); }
+  return update(true, sensor.getCursorX(), sensor.getCursorY(), now);
+}
+
+
+/**
+ * Classifies one cursor sample
+ * \param inView : isCursorInView() for the sample
+ * \param x : cursor X (ignored when not in view)
+ * \param y : cursor Y (ignored when not in view)
+ * \param nowMs : time of the sample (Ex: millis())
+ * \return \link Gesture \endlink : the swipe recognized on this sample, or GES_NONE
+ */
+Gesture PAJ7620_SwipeRecognizer::update(bool inView, int x, int y, unsigned long nowMs)
+{
+  if (!inView)
+  {
+    historyCount = 0;
+    fired = false;
+    return GES_NONE;
+  }
+  if (fired)
+    { return GES_NONE; }
+
+  // Oldest start first, so the whole stroke is measured when it qualifies
+  for (uint8_t i = 0; i < historyCount; i++)
+  {
+    uint8_t slot = (historyHead + PAJ7620_SWIPE_HISTORY - historyCount + i) % PAJ7620_SWIPE_HISTORY;
+    unsigned long elapsed = nowMs - historyTime[slot];
+    if (elapsed == 0 || elapsed > maxDuration)
+      { continue; }
+
+    Gesture direction = classify(x - historyX[slot], y - historyY[slot], elapsed);
+    if (direction != GES_NONE)
+    {
+      fired = true;
+      return direction;
+    }
+  }
+
+  remember(x, y, nowMs);
+  return GES_NONE;
+}
+
+
+/**
+ * Checks the motion from one start sample against the thresholds
+ * \param dx : X travel since the start sample
+ * \param dy : Y travel since the start sample
+ * \param elapsed : ms since the start sample, not 0
+ * \return \link Gesture \endlink : the swipe, or GES_NONE. A swipe is kept as the last swipe
+ */
+Gesture PAJ7620_SwipeRecognizer::classify(int dx, int dy, unsigned long elapsed)
+{
+  unsigned int absX = (dx < 0) ? -dx : dx;
+  unsigned int absY = (dy < 0) ? -dy : dy;
+
+  // Dominant axis must have at least twice the travel of the other
+  unsigned int distance;
+  Gesture direction;
+  if (absX >= 2 * absY)
+  {
+    distance = absX;
+    direction = (dx > 0) ? GES_RIGHT : GES_LEFT;
+  }
+  else if (absY >= 2 * absX)
+  {
+    distance = absY;
+    direction = (dy > 0) ? GES_DOWN : GES_UP;
+  }
+  else
+    { return GES_NONE; }
+
+  if (distance < minDistance)
+    { return GES_NONE; }
+  unsigned long speed = (unsigned long)distance * 1000UL / elapsed;
+  if (speed < minSpeed)
+    { return GES_NONE; }
+
+  lastSwipe.gesture = direction;
+  lastSwipe.distance = distance;
+  lastSwipe.speed = (speed > 0xFFFF) ? 0xFFFF : speed;
+  lastSwipe.duration = elapsed;
+  return direction;
+}
+
+
+/**
+ * Stores a sample as a swipe start candidate
+ *
+ * \par
+ * Samples closer than maxDuration / #PAJ7620_SWIPE_HISTORY ms to the newest
+ * candidate are skipped, so the history spans the maximum duration at any
+ * sampling rate. When full, the oldest candidate is dropped.
+ * \param x : cursor X
+ * \param y : cursor Y
+ * \param nowMs : time of the sample
+ * \return none
+ */
+void PAJ7620_SwipeRecognizer::remember(int x, int y, unsigned long nowMs)
+{
+  if (historyCount)
+  {
+    uint8_t newest = (historyHead + PAJ7620_SWIPE_HISTORY - 1) % PAJ7620_SWIPE_HISTORY;
+    if (nowMs - historyTime[newest] < (unsigned long)maxDuration / PAJ7620_SWIPE_HISTORY)
+      { return; }
+  }
+
+  historyX[historyHead] = x;
+  historyY[historyHead] = y;
+  historyTime[historyHead] = nowMs;
+  historyHead = (historyHead + 1) % PAJ7620_SWIPE_HISTORY;
+  if (historyCount < PAJ7620_SWIPE_HISTORY)
+    { historyCount++; }
+}
+
+
+/**
+ * Gets the measurements of the last swipe recognized
+ * \param info : \link SwipeInfo \endlink to fill (gesture is GES_NONE if none yet)
+ * \return none
+ */
+void PAJ7620_SwipeRecognizer::getLastSwipe(SwipeInfo &info)
+{
+  info = lastSwipe;
+}
+
+
+/**
+ * Forgets any motion in progress and the last swipe
+ * \param none
+ * \return none
+ */
+void PAJ7620_SwipeRecognizer::reset()
+{
+  fired = false;
+  historyHead = 0;
+  historyCount = 0;
+  lastSwipe.gesture = GES_NONE;
+  lastSwipe.distance = 0;
+  lastSwipe.speed = 0;
+  lastSwipe.duration = 0;
+}
@@ -0,0 +1,95 @@
+/**
+  \file RevEng_PAJ7620_Swipe.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Software swipe recognizer running on cursor mode samples. Reports a
+  directional \link Gesture \endlink as soon as the hand has moved far and
+  fast enough, without the sensor's gesture exit delay.
+*/
+
+#ifndef __PAJ7620_SWIPE_H__
+#define __PAJ7620_SWIPE_H__
+
+#include "RevEng_PAJ7620.h"
+
+/** @name Swipe recognizer defaults */
+/**@{*/
+/** Cursor counts the hand must travel along one axis */
+#define PAJ7620_SWIPE_MIN_DISTANCE        800
+/** Average cursor counts per second over the swipe */
+#define PAJ7620_SWIPE_MIN_SPEED           4000
+/** ms a swipe may take - slower motion restarts the measurement */
+#define PAJ7620_SWIPE_MAX_DURATION        400
+/**@}*/
+
+/** Recent samples kept as swipe start candidates, spread over the max duration */
+#define PAJ7620_SWIPE_HISTORY             8
+
+
+/**
+ * Measurements of the last recognized swipe
+ */
+struct SwipeInfo {
+  Gesture gesture;          /**< GES_UP, GES_DOWN, GES_LEFT or GES_RIGHT */
+  uint16_t distance;        /**< Cursor counts travelled along the swipe axis */
+  uint16_t speed;           /**< Average cursor counts per second */
+  uint16_t duration;        /**< ms from the start of the motion to recognition */
+};
+
+
+/**
+ * Classifies swipes from a stream of cursor samples
+ *
+ * \par
+ * Each sample is measured against a short history of earlier samples, kept
+ * about maxDuration / #PAJ7620_SWIPE_HISTORY ms apart and no older than the
+ * maximum duration. A swipe is reported on the first sample where, from one
+ * of those starts, the travel along the dominant axis reaches the distance
+ * threshold, at the speed threshold, and is at least twice the travel along
+ * the other axis. Since the start moves with the hand, time spent hovering
+ * before a stroke is not averaged into its speed. One swipe is reported per
+ * pass: the object has to leave the view before the next one.
+ *
+ * \par
+ * Integer math only, at most #PAJ7620_SWIPE_HISTORY checks per sample. Feed
+ * it every cursor sample - the faster the sampling, the lower the latency.
+ * \note Directions follow cursor coordinates: X grows to the right and
+ *   Y grows downward, after any setOrientation()
+ */
+class PAJ7620_SwipeRecognizer
+{
+  public:
+    PAJ7620_SwipeRecognizer(uint16_t minDistance = PAJ7620_SWIPE_MIN_DISTANCE,
+                            uint16_t minSpeed = PAJ7620_SWIPE_MIN_SPEED,
+                            uint16_t maxDuration = PAJ7620_SWIPE_MAX_DURATION);
+
+    Gesture update(RevEng_PAJ7620 &sensor);     // Samples the sensor, timed by its clock
+    Gesture update(bool inView, int x, int y, unsigned long nowMs);
+
+    void getLastSwipe(SwipeInfo &info);
+    void reset();
+
+  private:
+    uint16_t minDistance;
+    uint16_t minSpeed;
+    uint16_t maxDuration;
+
+    bool fired;                 // Swipe already reported for this pass
+    int historyX[PAJ7620_SWIPE_HISTORY];    // Ring of swipe start candidates
+    int historyY[PAJ7620_SWIPE_HISTORY];
+    unsigned long historyTime[PAJ7620_SWIPE_HISTORY];
+    uint8_t historyHead;        // Slot the next sample is stored in
+    uint8_t historyCount;
+    SwipeInfo lastSwipe;
+
+    Gesture classify(int dx, int dy, unsigned long elapsed);
+    void remember(int x, int y, unsigned long nowMs);
+};
+
+#endif
@@ -0,0 +1,155 @@
+/**
+  \file RevEng_PAJ7620_WaveAccumulator.cpp
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+*/
+
+#include "RevEng_PAJ7620_WaveAccumulator.h"
+
+
+/**
+ * Wave accumulator constructor
+ * \param windowMs : span of recent polls the rate is estimated over
+ */
+PAJ7620_WaveAccumulator::PAJ7620_WaveAccumulator(unsigned long windowMs)
+{
+  window = windowMs ? windowMs : 1;
+  reset();
+}
+
+
+/**
+ * Reads the sensor's wave count and accumulates it, timed by the sensor's clock source
+ * \param sensor : initialized driver
+ * \return uint32_t : running total of waves
+ */
+uint32_t PAJ7620_WaveAccumulator::update(RevEng_PAJ7620 &sensor)
+{
+  uint8_t raw = sensor.getWaveCount();
+  return update(raw, sensor.getClockSource()->nowMillis());
+}
+
+
+/**
+ * Accumulates a wave count reading
+ *
+ * \par
+ * The first reading only sets the starting point - waves counted by the
+ * sensor before the accumulator started are not included.
+ * \param rawCount : wave counter value (only bits [3:0] are used)
+ * \param nowMs : time of the reading (Ex: millis())
+ * \return uint32_t : running total of waves
+ */
+uint32_t PAJ7620_WaveAccumulator::update(uint8_t rawCount, unsigned long nowMs)
+{
+  rawCount &= 0x0F;
+  if (started)
+    { runningTotal += (uint8_t)(rawCount - lastRaw) & 0x0F; }   // Wrap safe
+  started = true;
+  lastRaw = rawCount;
+
+  sampleTime[sampleHead] = nowMs;
+  sampleTotal[sampleHead] = runningTotal;
+  sampleHead = (sampleHead + 1) % PAJ7620_WAVE_SAMPLES;
+  if (sampleCount < PAJ7620_WAVE_SAMPLES)
+    { sampleCount++; }
+
+  unsigned long rate = wavesPerMinute();
+  if (rate > peakRate)
+    { peakRate = rate; }
+  return runningTotal;
+}
+
+
+/**
+ * Returns the running total
+ * \param none
+ * \return uint32_t : waves counted since construction or reset()
+ */
+uint32_t PAJ7620_WaveAccumulator::total()
+{
+  return runningTotal;
+}
+
+
+/**
+ * Estimates the wave rate over the sliding window
+ *
+ * \par
+ * Uses the oldest remembered poll that is still inside the window, so the
+ * estimate covers the window once polls are frequent enough to fill it.
+ * \param none
+ * \return unsigned long : waves per minute, 0 until two polls are in the window
+ */
+unsigned long PAJ7620_WaveAccumulator::wavesPerMinute()
+{
+  if (sampleCount < 2)
+    { return 0; }
+
+  uint8_t newest = (sampleHead + PAJ7620_WAVE_SAMPLES - 1) % PAJ7620_WAVE_SAMPLES;
+  uint8_t oldest = newest;
+  for (uint8_t i = 1; i < sampleCount; i++)
+  {
+    uint8_t slot = (newest + PAJ7620_WAVE_SAMPLES - i) % PAJ7620_WAVE_SAMPLES;
+    if (sampleTime[newest] - sampleTime[slot] > window)
+      { break; }
+    oldest = slot;
+  }
+
+  unsigned long span = sampleTime[newest] - sampleTime[oldest];
+  if (span == 0)
+    { return 0; }
+  // At most 15 waves per remembered poll, so the product fits in 32 bits
+  return (sampleTotal[newest] - sampleTotal[oldest]) * 60000UL / span;
+}
+
+
+/**
+ * Poll interval that keeps up with the fastest wave rate measured so far
+ * \param none
+ * \return unsigned long : ms between polls
+ * \see recommendedPollInterval(unsigned long)
+ */
+unsigned long PAJ7620_WaveAccumulator::recommendedPollInterval()
+{
+  return recommendedPollInterval(peakRate);
+}
+
+
+/**
+ * Poll interval that loses no waves at a given wave rate
+ *
+ * \par
+ * Half the time the counter takes to gain #PAJ7620_WAVE_MAX_PER_POLL
+ * waves at the expected rate, leaving room for bursts of faster waving.
+ * \param expectedWavesPerMinute : fastest rate the application expects
+ * \return unsigned long : ms between polls
+ */
+unsigned long PAJ7620_WaveAccumulator::recommendedPollInterval(unsigned long expectedWavesPerMinute)
+{
+  if (expectedWavesPerMinute == 0)
+    { expectedWavesPerMinute = 1; }
+  return (PAJ7620_WAVE_MAX_PER_POLL * 60000UL / 2) / expectedWavesPerMinute;
+}
+
+
+/**
+ * Zeroes the total and forgets the rate history
+ * \note The next reading becomes the new starting point
+ * \param none
+ * \return none
+ */
+void PAJ7620_WaveAccumulator::reset()
+{
+  started = false;
+  lastRaw = 0;
+  runningTotal = 0;
+  peakRate = 0;
+  sampleHead = 0;
+  sampleCount = 0;
+}
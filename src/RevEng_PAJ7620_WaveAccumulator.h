@@ -0,0 +1,64 @@
+/**
+  \file RevEng_PAJ7620_WaveAccumulator.h
+
+  \version 1.4.0
+
+  \copyright
+  \parblock
+  License: The MIT License (MIT) - same as RevEng_PAJ7620.h
+  \endparblock
+
+  Turns the sensor's 4 bit wave counter into a 32 bit running total and a
+  wave rate, and says how often to poll so no waves are lost.
+*/
+
+#ifndef __PAJ7620_WAVE_ACCUMULATOR_H__
+#define __PAJ7620_WAVE_ACCUMULATOR_H__
+
+#include "RevEng_PAJ7620.h"
+
+/** Polls remembered for the rate estimate */
+#define PAJ7620_WAVE_SAMPLES              16
+/** Default rate window in ms */
+#define PAJ7620_WAVE_WINDOW_MS            10000
+/** Most waves the sensor's counter can gain between two polls without wrapping past the last value */
+#define PAJ7620_WAVE_MAX_PER_POLL         15
+
+
+/**
+ * Accumulates the wave counter (bank 0, 0xB7 [3:0])
+ *
+ * \par
+ * The counter wraps from 15 to 0, so each poll adds the difference from
+ * the previous poll modulo 16. Up to 15 waves between two polls are
+ * counted correctly; 16 or more look like fewer. recommendedPollInterval()
+ * gives a poll period that stays well inside that limit.
+ */
+class PAJ7620_WaveAccumulator
+{
+  public:
+    PAJ7620_WaveAccumulator(unsigned long windowMs = PAJ7620_WAVE_WINDOW_MS);
+
+    uint32_t update(RevEng_PAJ7620 &sensor);            // getWaveCount() at the sensor clock's millis
+    uint32_t update(uint8_t rawCount, unsigned long nowMs);
+
+    uint32_t total();                   // Waves since construction / reset()
+    unsigned long wavesPerMinute();     // Rate over the sliding window
+    unsigned long recommendedPollInterval();    // ms, from the fastest rate seen
+    static unsigned long recommendedPollInterval(unsigned long expectedWavesPerMinute);
+    void reset();
+
+  private:
+    unsigned long window;
+    bool started;                       // A first reading has been taken
+    uint8_t lastRaw;
+    uint32_t runningTotal;
+    unsigned long peakRate;             // Fastest wavesPerMinute() seen
+
+    unsigned long sampleTime[PAJ7620_WAVE_SAMPLES];     // Ring of poll times
+    uint32_t sampleTotal[PAJ7620_WAVE_SAMPLES];         // Total at each poll
+    uint8_t sampleHead;                 // Next slot to fill
+    uint8_t sampleCount;
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+#include "RevEng_PAJ7620_AdaptiveTiming.h"
+
+std::deque<uint8_t> *miso;
+
+// Simulated clock that raises a gesture flag once its time comes, so the
+// driver's flag reads during a window see it at the right moment
+class HandClock : public PAJ7620_SimClock
+{
+  public:
+    HandClock() : flag(0), flagAt(0) {}
+    void sleepMillis(unsigned long ms)
+    {
+      PAJ7620_SimClock::sleepMillis(ms);
+      deliver();
+    }
+    void schedule(uint8_t newFlag, unsigned long atMs) { flag = newFlag; flagAt = atMs; }
+    bool deliver()
+    {
+      if (!flag || nowMillis() < flagAt)
+        { return false; }
+      miso->push_back(flag);
+      flag = 0;
+      return true;
+    }
+    uint8_t flag;
+    unsigned long flagAt;
+};
+
+RevEng_PAJ7620 *sensor;
+HandClock *hand;
+PAJ7620_AdaptiveTiming *timing;
+
+struct Stroke {
+  Gesture first;            // Returned by the first readGesture()
+  Gesture late;             // Follow-up read after the window closed, GES_NONE if none
+  unsigned long latency;    // ms the first readGesture() took
+};
+
+// One hand movement: a flag, optionally a second flag followDelay ms later,
+// then a second of nothing before the next movement
+Stroke stroke(uint8_t flag, uint8_t followFlag, unsigned long followDelay)
+{
+  Stroke s = {GES_NONE, GES_NONE, 0};
+  unsigned long start = hand->nowMillis();
+  miso->push_back(flag);
+  if (followFlag)
+    { hand->schedule(followFlag, start + followDelay); }
+
+  s.first = sensor->readGesture();
+  s.latency = hand->nowMillis() - start;
+  if (hand->flag)
+  {
+    hand->advanceMillis(hand->flagAt - hand->nowMillis());
+    hand->deliver();
+    s.late = sensor->readGesture();
+  }
+  miso->clear();
+  hand->advanceMillis(1000);
+  sensor->readGesture();                    // Idle poll settles the window
+  miso->clear();
+  return s;
+}
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  hand = new HandClock();
+  timing = new PAJ7620_AdaptiveTiming();
+  sensor = new RevEng_PAJ7620();
+  sensor->setClockSource(hand);
+  sensor->begin();
+  sensor->setAdaptiveTiming(timing);
+  miso->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  delete timing;
+  delete hand;
+  sensor = NULL;
+}
+
+unittest(starting_windows)
+{
+  assertEqual(PAJ7620_TIMING_MIN_MS, timing->window(GES_LEFT));
+  assertEqual(PAJ7620_TIMING_MIN_MS, timing->window(GES_UP));
+  assertEqual(200, timing->window(GES_FORWARD));
+  assertEqual(200, timing->window(GES_BACKWARD));
+  assertEqual(0, timing->window(GES_WAVE));
+}
+
+unittest(quick_user_exit_window_shrinks)
+{
+  Stroke s = stroke(GES_FORWARD_FLAG, 0, 0);
+  assertEqual(GES_FORWARD, s.first);
+  assertEqual(200UL, s.latency);
+
+  for (int i = 0; i < 60; i++)
+    { s = stroke(GES_FORWARD_FLAG, 0, 0); }
+  assertEqual(GES_FORWARD, s.first);
+  assertEqual((unsigned long)PAJ7620_TIMING_MIN_MS, s.latency);
+  assertEqual(200, timing->window(GES_BACKWARD));   // Untouched class
+  assertEqual(0, timing->falsePositiveRate(GES_FORWARD));
+}
+
+unittest(withdrawal_flags_keep_exit_window_open)
+{
+  // Every forward is followed by a backward flag 120ms later as the hand leaves
+  for (int i = 0; i < 60; i++)
+  {
+    Stroke s = stroke(GES_FORWARD_FLAG, GES_BACKWARD_FLAG, 120);
+    assertEqual(GES_FORWARD, s.first);
+    assertEqual(GES_NONE, s.late);          // Dropped inside the window
+  }
+  assertMoreOrEqual(timing->window(GES_FORWARD), 150);   // 120ms + 25%
+  assertLess(timing->window(GES_FORWARD), 200);
+}
+
+unittest(quick_unrelated_gesture_after_forward_is_not_a_miss)
+{
+  // Fast user: forward, then a deliberate left swipe just after the window
+  for (int i = 0; i < 10; i++)
+  {
+    Stroke s = stroke(GES_FORWARD_FLAG, GES_LEFT_FLAG, 250);
+    assertEqual(GES_FORWARD, s.first);
+    assertEqual(GES_LEFT, s.late);
+  }
+  assertLessOrEqual(timing->window(GES_FORWARD), 200);
+  assertEqual(0, timing->falsePositiveRate(GES_FORWARD));
+}
+
+unittest(miss_horizon_starts_when_the_window_closes)
+{
+  // Backward 500ms after forward: past the horizon counted from the trigger,
+  //  but only 300ms after the 200ms exit window closed
+  Stroke s = stroke(GES_FORWARD_FLAG, GES_BACKWARD_FLAG, 500);
+  assertEqual(GES_FORWARD, s.first);
+  assertEqual(GES_BACKWARD, s.late);
+  assertMoreOrEqual(timing->falsePositiveRate(GES_FORWARD), 5);
+  assertMore(timing->window(GES_FORWARD), 200);
+}
+
+unittest(late_follow_up_grows_entry_window)
+{
+  // A push toward the sensor flags RIGHT first, then FORWARD 60ms later
+  Stroke s = stroke(GES_RIGHT_FLAG, GES_FORWARD_FLAG, 60);
+  assertEqual(GES_RIGHT, s.first);          // 20ms window missed it
+  assertEqual(GES_FORWARD, s.late);
+  assertMoreOrEqual(timing->falsePositiveRate(GES_RIGHT), 5);
+
+  for (int i = 0; i < 10; i++)
+    { s = stroke(GES_RIGHT_FLAG, GES_FORWARD_FLAG, 60); }
+  assertEqual(GES_FORWARD, s.first);        // Learned: caught inside the window
+  assertEqual(GES_NONE, s.late);
+  assertMoreOrEqual(timing->window(GES_LEFT), 75);
+  assertEqual(PAJ7620_TIMING_MIN_MS, timing->window(GES_UP));
+}
+
+unittest(caught_follow_up_returns_early)
+{
+  GestureTiming saved = {PAJ7620_TIMING_MARKER, 300, 300, 20, 20};
+  timing->setTiming(saved);
+  Stroke s = stroke(GES_UP_FLAG, GES_BACKWARD_FLAG, 40);
+  assertEqual(GES_BACKWARD, s.first);
+  assertEqual(60UL, s.latency);             // 40ms follow-up + 20ms exit, not 300ms
+}
+
+unittest(windows_stay_in_bounds)
+{
+  for (int i = 0; i < 40; i++)
+    { stroke(GES_DOWN_FLAG, GES_FORWARD_FLAG, 390); }
+  assertEqual(PAJ7620_TIMING_MAX_MS, timing->window(GES_DOWN));
+  for (int i = 0; i < 200; i++)
+    { stroke(GES_DOWN_FLAG, 0, 0); }
+  assertEqual(PAJ7620_TIMING_MIN_MS, timing->window(GES_DOWN));
+}
+
+unittest(timing_persists)
+{
+  for (int i = 0; i < 10; i++)
+    { stroke(GES_LEFT_FLAG, GES_BACKWARD_FLAG, 90); }
+  GestureTiming saved;
+  timing->getTiming(saved);
+  assertEqual(PAJ7620_TIMING_MARKER, saved.marker);
+  assertEqual(timing->window(GES_LEFT), saved.entryHorizontal);
+
+  PAJ7620_AdaptiveTiming restored;
+  assertEqual(1, restored.setTiming(saved));
+  assertEqual(timing->window(GES_RIGHT), restored.window(GES_RIGHT));
+  assertEqual(timing->window(GES_FORWARD), restored.window(GES_FORWARD));
+
+  saved.marker = 0;
+  assertEqual(0, restored.setTiming(saved));
+}
+
+unittest(fixed_times_without_adaptive_timing)
+{
+  sensor->setAdaptiveTiming(NULL);
+  Stroke s = stroke(GES_FORWARD_FLAG, 0, 0);
+  assertEqual(200UL, s.latency);
+}
+
+unittest_main()
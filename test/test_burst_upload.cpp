@@ -0,0 +1,287 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+uint8_t traceBuffer[2048];
+std::deque<uint8_t> *miso;
+
+// Register contents and write statistics rebuilt from a recorded trace
+struct Replayed {
+  uint8_t regs[2][256];
+  int writes;                           // Write transactions
+  int reads;                            // Read transactions
+  bool bankSelectInRun;                 // A multi register write covered 0xEF
+  std::vector<uint8_t> runValues;       // Data of multi register writes, in order
+  std::vector<uint8_t> runLengths;      // Registers in each multi register write
+};
+
+void replayWrites(const uint8_t trace[], size_t length, Replayed &out)
+{
+  memset(out.regs, 0, sizeof(out.regs));
+  out.writes = 0;
+  out.reads = 0;
+  out.bankSelectInRun = false;
+  out.runValues.clear();
+  out.runLengths.clear();
+  uint8_t bank = 0;
+
+  size_t i = 0;
+  while (i < length)
+  {
+    bool isRead = trace[i] & PAJ7620_TRACE_READ;
+    uint8_t count = trace[i] & PAJ7620_TRACE_LENGTH_MASK;
+    uint8_t reg = trace[i + 1];
+    i += 2;
+    while (trace[i++] & 0x80) {}        // Skip the time delta
+    if (isRead)
+      { out.reads++; }
+    else
+    {
+      out.writes++;
+      if (count > 1)
+        { out.runLengths.push_back(count); }
+      for (uint8_t n = 0; n < count; n++)
+      {
+        uint8_t value = trace[i + n];
+        if (count > 1)
+        {
+          out.runValues.push_back(value);
+          if (reg + n == PAJ7620_REGISTER_BANK_SEL)
+            { out.bankSelectInRun = true; }
+        }
+        if (reg + n == PAJ7620_REGISTER_BANK_SEL)
+          { bank = value & 0x01; }
+        out.regs[bank][(uint8_t)(reg + n)] = value;
+      }
+    }
+    i += count;
+  }
+}
+
+// Records begin() and a switch to cursor mode with the given upload mode
+void recordSession(uint8_t mode, Replayed &out, bool thenCursorMode = true)
+{
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+
+  PAJ7620_I2CTrace recorder;
+  recorder.beginRecording(traceBuffer, sizeof(traceBuffer));
+  RevEng_PAJ7620 sensor;
+  sensor.setI2CTrace(&recorder);
+  sensor.setBurstUploads(mode);
+  sensor.begin();
+  if (thenCursorMode)
+    { sensor.setCursorMode(); }
+  assertFalse(recorder.overflowed());
+  replayWrites(traceBuffer, recorder.length(), out);
+}
+
+// Records only the switch to cursor mode, after a plain begin()
+void recordCursorMode(RevEng_PAJ7620 &sensor, Replayed &out)
+{
+  PAJ7620_I2CTrace recorder;
+  recorder.beginRecording(traceBuffer, sizeof(traceBuffer));
+  sensor.setI2CTrace(&recorder);
+  sensor.setCursorMode();
+  sensor.setI2CTrace(NULL);
+  replayWrites(traceBuffer, recorder.length(), out);
+}
+
+unittest_setup()
+{
+  GODMODE()->reset();
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+}
+
+unittest(verify_is_default_and_invalid_modes_fall_back)
+{
+  RevEng_PAJ7620 sensor;
+  assertEqual(PAJ7620_BURST_VERIFY, sensor.getBurstUploads());
+  sensor.setBurstUploads(PAJ7620_BURST_ON);
+  assertEqual(PAJ7620_BURST_ON, sensor.getBurstUploads());
+  sensor.setBurstUploads(7);
+  assertEqual(PAJ7620_BURST_VERIFY, sensor.getBurstUploads());
+}
+
+unittest(bursts_write_the_same_registers_in_fewer_transactions)
+{
+  static Replayed single, burst;
+  recordSession(PAJ7620_BURST_OFF, single);
+  recordSession(PAJ7620_BURST_ON, burst);
+
+  assertTrue(single.runValues.empty());
+  assertFalse(burst.runValues.empty());
+  assertLess(burst.writes, single.writes);
+  assertEqual(0, memcmp(single.regs, burst.regs, sizeof(single.regs)));
+}
+
+unittest(bank_select_is_never_part_of_a_run)
+{
+  static Replayed burst;
+  recordSession(PAJ7620_BURST_ON, burst);
+  assertFalse(burst.bankSelectInRun);
+}
+
+unittest(default_begin_proves_bursts_on_the_init_upload)
+{
+  static Replayed init;
+  recordSession(PAJ7620_BURST_ON, init, false);
+
+  // Register backed sensor: each run register reads back as written (only
+  //  the first table is verified, the rest of the values go unread)
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  for (size_t i = 0; i < init.runValues.size(); i++)
+    { miso->push_back(init.runValues[i]); }
+
+  RevEng_PAJ7620 sensor;
+  assertEqual(1, sensor.begin());
+  assertEqual(PAJ7620_BURST_ON, sensor.getBurstUploads());
+}
+
+unittest(verify_promotes_to_bursts_once_they_read_back)
+{
+  static Replayed plain;
+  RevEng_PAJ7620 sensor;
+  sensor.setBurstUploads(PAJ7620_BURST_ON);
+  sensor.begin();
+  recordCursorMode(sensor, plain);
+
+  // Same upload again, verified: every run register reads back as written
+  sensor.setGestureMode();
+  sensor.setBurstUploads(PAJ7620_BURST_VERIFY);
+  for (size_t i = 0; i < plain.runValues.size(); i++)
+    { miso->push_back(plain.runValues[i]); }
+  sensor.setCursorMode();
+
+  assertEqual(PAJ7620_BURST_ON, sensor.getBurstUploads());
+  assertEqual(0, miso->size());
+
+  // Proven: later uploads are not read back
+  miso->push_back(0x5A);
+  sensor.setGestureMode();
+  assertEqual(1, miso->size());
+}
+
+unittest(verify_falls_back_to_single_writes)
+{
+  static Replayed plain, fallback;
+  RevEng_PAJ7620 sensor;
+  sensor.setBurstUploads(PAJ7620_BURST_ON);
+  sensor.begin();
+  recordCursorMode(sensor, plain);
+  sensor.setGestureMode();
+
+  // First run register ignored the burst but takes a single write
+  uint8_t first = plain.runValues[0];
+  sensor.setBurstUploads(PAJ7620_BURST_VERIFY);
+  miso->push_back(~first);
+  for (uint8_t i = 1; i < plain.runLengths[0]; i++)
+    { miso->push_back(plain.runValues[i]); }
+  miso->push_back(first);               // Single read after the single rewrite
+  sensor.setCursorMode();
+  assertEqual(PAJ7620_BURST_OFF, sensor.getBurstUploads());
+
+  // Later uploads are one write per register
+  sensor.setGestureMode();
+  recordCursorMode(sensor, fallback);
+  assertTrue(fallback.runValues.empty());
+}
+
+unittest(verify_reads_each_run_back_in_one_burst)
+{
+  static Replayed plain, verified;
+  RevEng_PAJ7620 sensor;
+  sensor.setBurstUploads(PAJ7620_BURST_ON);
+  sensor.begin();
+  recordCursorMode(sensor, plain);
+  sensor.setGestureMode();
+
+  sensor.setBurstUploads(PAJ7620_BURST_VERIFY);
+  for (size_t i = 0; i < plain.runValues.size(); i++)
+    { miso->push_back(plain.runValues[i]); }
+  recordCursorMode(sensor, verified);
+
+  assertEqual(PAJ7620_BURST_ON, sensor.getBurstUploads());
+  assertEqual(plain.writes, verified.writes);
+  assertEqual(plain.reads + (int)plain.runLengths.size(), verified.reads);
+}
+
+unittest(burst_off_splits_config_and_restore_writes)
+{
+  static Replayed split, burst;
+  RegisterSnapshot snap;
+  for (int i = 0; i < PAJ7620_SNAPSHOT_SIZE; i++)
+    { snap.values[i] = i + 1; }
+  ProximityCalibration cal = { PAJ7620_PS_CAL_MARKER, 90, 70, 0x02, 60, 3 };
+
+  // Same config, restore and thresholds with bursts off and on
+  for (int pass = 0; pass < 2; pass++)
+  {
+    RevEng_PAJ7620 sensor;
+    sensor.setBurstUploads(pass ? PAJ7620_BURST_ON : PAJ7620_BURST_OFF);
+    sensor.begin();
+    sensor.setCursorMode();
+    CursorConfig config;
+    sensor.getCursorConfig(config);
+    config.positionFilterStart = 0x123;
+    config.objectSizeThreshold = 0x20;
+    config.positionResolution = 0x05;
+
+    PAJ7620_I2CTrace recorder;
+    recorder.beginRecording(traceBuffer, sizeof(traceBuffer));
+    sensor.setI2CTrace(&recorder);
+    assertEqual(1, sensor.applyCursorConfig(config));
+    assertEqual(1, sensor.restore(snap));
+    assertEqual(1, sensor.applyProximityCalibration(cal));
+    sensor.setI2CTrace(NULL);
+    replayWrites(traceBuffer, recorder.length(), pass ? burst : split);
+    miso->push_back(PAJ7620_PART_ID_LSB);
+    miso->push_back(PAJ7620_PART_ID_MSB);
+  }
+
+  // A sensor that does not auto-increment still gets every value
+  assertTrue(split.runValues.empty());
+  assertFalse(burst.runValues.empty());
+  assertEqual(0, memcmp(split.regs, burst.regs, sizeof(split.regs)));
+}
+
+unittest(nothing_read_back_keeps_verifying)
+{
+  // Short reads: nothing matches either way, so bursts are neither blamed
+  //  nor trusted, and the next upload is verified again
+  RevEng_PAJ7620 sensor;
+  sensor.begin();
+  assertEqual(PAJ7620_BURST_VERIFY, sensor.getBurstUploads());
+  sensor.setCursorMode();
+  assertEqual(PAJ7620_BURST_VERIFY, sensor.getBurstUploads());
+}
+
+unittest(sliced_upload_uses_runs_too)
+{
+  static Replayed plain;
+  RevEng_PAJ7620 sensor;
+  sensor.setBurstUploads(PAJ7620_BURST_ON);
+  sensor.begin();
+  recordCursorMode(sensor, plain);
+  sensor.setGestureMode();
+
+  PAJ7620_I2CTrace recorder;
+  recorder.beginRecording(traceBuffer, sizeof(traceBuffer));
+  sensor.setI2CTrace(&recorder);
+  sensor.requestCursorMode();
+  while (sensor.serviceBus(0)) {}
+  sensor.setI2CTrace(NULL);
+
+  static Replayed sliced;
+  replayWrites(traceBuffer, recorder.length(), sliced);
+  assertTrue(sliced.runValues == plain.runValues);
+}
+
+unittest_main()
@@ -0,0 +1,93 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+// Fake client: every slice costs sliceCost us of bus time and does one unit of work
+struct FakeClient {
+  int workLeft;
+  unsigned long sliceCost;
+  int tag;
+};
+
+int servedLog[16];
+int servedCount;
+
+bool fakeSlice(void *context, unsigned long budgetUs)
+{
+  FakeClient *client = static_cast<FakeClient *>(context);
+  GODMODE()->micros += client->sliceCost;
+  servedLog[servedCount++ % 16] = client->tag;
+  return --client->workLeft > 0;
+}
+
+unittest_setup()
+{
+  GODMODE()->reset();
+  servedCount = 0;
+}
+
+unittest(higher_priority_runs_first)
+{
+  PAJ7620_BusScheduler scheduler;
+  FakeClient display = { 2, 100, 1 };
+  FakeClient sensor = { 2, 100, 2 };
+  int8_t sensorId = scheduler.addClient(fakeSlice, &sensor, 1);
+  int8_t displayId = scheduler.addClient(fakeSlice, &display, 5);
+  scheduler.request(sensorId);
+  scheduler.request(displayId);
+
+  assertFalse(scheduler.run(10000));
+  assertEqual(4, servedCount);
+  assertEqual(1, servedLog[0]);
+  assertEqual(1, servedLog[1]);
+  assertEqual(2, servedLog[2]);
+  assertEqual(2, servedLog[3]);
+}
+
+unittest(budget_bounds_each_run)
+{
+  PAJ7620_BusScheduler scheduler;
+  FakeClient sensor = { 10, 300, 2 };
+  int8_t id = scheduler.addClient(fakeSlice, &sensor, 1);
+  scheduler.request(id);
+
+  assertTrue(scheduler.run(1000));      // 300us slices -> 4 fit before 1000us is passed
+  assertEqual(4, servedCount);
+  assertEqual(1200, scheduler.busyMicros(id));
+  GODMODE()->micros += 1200;            // Idle time for other bus users
+  assertEqual(50, scheduler.utilization(id));
+}
+
+unittest(utilization_survives_long_windows)
+{
+  PAJ7620_BusScheduler scheduler;
+  FakeClient sensor = { 1, 60000000UL, 2 };   // One minute on the bus
+  int8_t id = scheduler.addClient(fakeSlice, &sensor, 1);
+  scheduler.request(id);
+
+  scheduler.run(0);
+  GODMODE()->micros += 20000000UL;
+  assertEqual(75, scheduler.utilization(id));
+}
+
+unittest(driver_mode_change_is_sliced)
+{
+  Wire.resetMocks();
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_LSB);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_MSB);
+  RevEng_PAJ7620 sensor;
+  sensor.begin();
+
+  PAJ7620_BusScheduler scheduler;
+  int8_t id = scheduler.addClient(RevEng_PAJ7620::busSlice, &sensor, 1);
+  sensor.requestCursorMode();
+  scheduler.request(id);
+
+  int slices = 0;
+  while (scheduler.run(0))              // Zero budget: one register run per slice
+    { slices++; }
+  assertMore(slices, 1);
+  assertLess(slices, (int)SET_CURSOR_MODE_REG_ARRAY_SIZE - 1);
+  assertFalse(sensor.isBusWorkPending());
+}
+
+unittest_main()
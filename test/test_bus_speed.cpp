@@ -0,0 +1,130 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+std::deque<uint8_t> *mosi;
+std::deque<uint8_t> *miso;
+
+// Queue the answers for rounds good part-ID and scratch round trips
+void pushGoodRounds(uint8_t rounds)
+{
+  for (uint8_t i = 0; i < rounds; i++)
+  {
+    miso->push_back(PAJ7620_PART_ID_LSB);
+    miso->push_back(PAJ7620_PART_ID_MSB);
+    miso->push_back((i & 1) ? 0xAA : 0x55);
+  }
+}
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  Wire.clock = 100000;
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(begin_keeps_wire_clock_by_default)
+{
+  Wire.clock = 123456;
+  assertEqual(1, sensor->begin());
+  assertEqual(123456UL, Wire.clock);
+  assertEqual(0UL, sensor->getBusClock());
+}
+
+unittest(begin_sets_requested_clock)
+{
+  assertEqual(1, sensor->begin(&Wire, 400000));
+  assertEqual(400000UL, Wire.clock);
+  assertEqual(400000UL, sensor->getBusClock());
+}
+
+unittest(probe_uses_max_when_every_speed_passes)
+{
+  sensor->begin();
+  for (int speed = 0; speed < 4; speed++)
+    { pushGoodRounds(PAJ7620_PROBE_ROUNDS); }
+  assertEqual(400000UL, sensor->probeBusSpeed());
+  assertEqual(400000UL, Wire.clock);
+  assertEqual(0, miso->size());
+}
+
+unittest(probe_backs_off_from_failing_speed)
+{
+  sensor->begin();
+  pushGoodRounds(PAJ7620_PROBE_ROUNDS);     // 100kHz
+  pushGoodRounds(PAJ7620_PROBE_ROUNDS);     // 200kHz
+  pushGoodRounds(PAJ7620_PROBE_ROUNDS);     // 300kHz
+  pushGoodRounds(3);                        // 400kHz: scratch corrupted on round 4
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  miso->push_back(0x54);
+  assertEqual(200000UL, sensor->probeBusSpeed());
+  assertEqual(200000UL, Wire.clock);
+  assertEqual(200000UL, sensor->getBusClock());
+}
+
+unittest(probe_margin_is_configurable)
+{
+  sensor->begin();
+  pushGoodRounds(4);
+  pushGoodRounds(4);
+  miso->push_back(0x00);                    // Bad part ID at 300kHz
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  assertEqual(200000UL, sensor->probeBusSpeed(4, 0));
+  miso->clear();
+  pushGoodRounds(4);
+  pushGoodRounds(4);                        // 300kHz short read
+  assertEqual(100000UL, sensor->probeBusSpeed(4, 3));     // Never below the minimum
+}
+
+unittest(probe_reports_failure_at_slowest_speed)
+{
+  sensor->begin();
+  assertEqual(0UL, sensor->probeBusSpeed());  // Nothing answers
+  assertEqual(100000UL, Wire.clock);
+}
+
+unittest(probe_before_begin_does_nothing)
+{
+  assertEqual(0UL, sensor->probeBusSpeed());
+  assertEqual(100000UL, Wire.clock);
+  assertEqual(0UL, sensor->getBusClock());
+}
+
+unittest(probe_restores_scratch_register)
+{
+  sensor->begin();
+  pushGoodRounds(PAJ7620_PROBE_ROUNDS);
+  mosi->clear();
+  sensor->probeBusSpeed();
+  // Last write: bank 0 select, then the scratch register's init value
+  assertEqual(PAJ7620_ADDR_PROBE_SCRATCH, mosi->at(mosi->size() - 2));
+  uint8_t initValue = 0;
+  for (unsigned int i = 0; i < INIT_REG_ARRAY_SIZE; i++)
+  {
+    if ((initRegisterArray[i] >> 8) == PAJ7620_ADDR_PROBE_SCRATCH)
+      { initValue = initRegisterArray[i] & 0xFF; }
+  }
+  assertEqual(initValue, mosi->back());
+}
+
+unittest(begin_can_probe)
+{
+  for (int speed = 0; speed < 3; speed++)
+    { pushGoodRounds(PAJ7620_PROBE_ROUNDS); }
+  assertEqual(1, sensor->begin(&Wire, PAJ7620_I2C_CLOCK_PROBE));
+  assertEqual(200000UL, sensor->getBusClock());     // 400kHz failed, one step margin
+  assertEqual(200000UL, Wire.clock);
+}
+
+unittest_main()
@@ -0,0 +1,141 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+#include "RevEng_PAJ7620_PollGovernor.h"
+
+RevEng_PAJ7620 *sensor;
+PAJ7620_SimClock *simClock;
+std::deque<uint8_t> *miso;
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  GODMODE()->reset();
+  simClock = new PAJ7620_SimClock();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->setClockSource(simClock);
+  sensor->begin();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  delete simClock;
+  sensor = NULL;
+}
+
+unittest(sim_clock_keeps_millis_and_micros_in_step)
+{
+  PAJ7620_SimClock clock;
+  clock.advance(700);
+  clock.advance(700);
+  assertEqual(1400UL, clock.nowMicros());
+  assertEqual(1UL, clock.nowMillis());
+  clock.advanceMillis(5);
+  assertEqual(6UL, clock.nowMillis());
+  assertEqual(6400UL, clock.nowMicros());
+  clock.advance(600);
+  assertEqual(7UL, clock.nowMillis());
+  assertEqual(0UL, clock.sleepCount());
+}
+
+unittest(begin_settle_time_uses_clock)
+{
+  assertEqual(700UL, simClock->nowMicros());
+  assertEqual(1UL, simClock->sleepCount());
+  assertEqual(0UL, GODMODE()->micros);      // Arduino time untouched
+}
+
+unittest(forward_waits_exit_time)
+{
+  simClock->clearSleeps();
+  unsigned long start = simClock->nowMillis();
+  miso->push_back(GES_FORWARD_FLAG);
+  assertEqual(GES_FORWARD, sensor->readGesture());
+  assertEqual(200UL, simClock->nowMillis() - start);
+  assertEqual(1UL, simClock->sleepCount());
+}
+
+unittest(directional_waits_entry_time_only)
+{
+  sensor->setGestureEntryTime(50);
+  simClock->clearSleeps();
+  unsigned long start = simClock->nowMillis();
+  miso->push_back(GES_LEFT_FLAG);
+  miso->push_back(0x00);                    // No Z-axis gesture after entry time
+  assertEqual(GES_LEFT, sensor->readGesture());
+  assertEqual(50UL, simClock->nowMillis() - start);
+}
+
+unittest(directional_becomes_backward_after_entry_and_exit)
+{
+  sensor->setGestureEntryTime(30);
+  sensor->setGestureExitTime(120);
+  unsigned long start = simClock->nowMillis();
+  miso->push_back(GES_UP_FLAG);
+  miso->push_back(GES_BACKWARD_FLAG);
+  assertEqual(GES_BACKWARD, sensor->readGesture());
+  assertEqual(150UL, simClock->nowMillis() - start);
+}
+
+unittest(no_gesture_does_not_sleep)
+{
+  simClock->clearSleeps();
+  assertEqual(GES_NONE, sensor->readGesture());
+  assertEqual(0UL, simClock->sleepCount());
+}
+
+unittest(thousands_of_timed_scenarios)
+{
+  const uint8_t flags[] = {GES_RIGHT_FLAG, GES_LEFT_FLAG, GES_FORWARD_FLAG, GES_DOWN_FLAG};
+  unsigned int seed = 7;
+  unsigned long expected = simClock->nowMillis();
+
+  for (int i = 0; i < 5000; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    unsigned long entry = (seed >> 8) % 400;
+    unsigned long exitTime = (seed >> 16) % 800;
+    uint8_t first = flags[(seed >> 24) % 4];
+    bool becomesForward = (seed >> 4) & 1;
+    sensor->setGestureEntryTime(entry);
+    sensor->setGestureExitTime(exitTime);
+
+    miso->push_back(first);
+    if (first == GES_FORWARD_FLAG)
+      { expected += exitTime; }
+    else
+    {
+      miso->push_back(becomesForward ? GES_FORWARD_FLAG : 0x00);
+      expected += entry + (becomesForward ? exitTime : 0);
+    }
+    Gesture result = sensor->readGesture();
+    assertTrue(first == GES_FORWARD_FLAG || becomesForward
+               ? result == GES_FORWARD : result != GES_FORWARD);
+    assertEqual(expected, simClock->nowMillis());
+  }
+  assertEqual(0UL, GODMODE()->micros);
+}
+
+unittest(poll_governor_on_sim_clock)
+{
+  PAJ7620_PollGovernor governor(20, 160);
+  governor.setClockSource(simClock);
+  governor.update(false);                   // 40ms
+  assertFalse(governor.isDue());
+  assertEqual(40UL, governor.timeUntilDue());
+  simClock->advanceMillis(39);
+  assertFalse(governor.isDue());
+  simClock->advanceMillis(1);
+  assertTrue(governor.isDue());
+}
+
+unittest(null_restores_arduino_clock)
+{
+  sensor->setClockSource(NULL);
+  assertTrue(sensor->getClockSource() == &PAJ7620_ArduinoClock::shared);
+}
+
+unittest_main()
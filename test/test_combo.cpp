@@ -0,0 +1,96 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620_Combo.h"
+
+const Gesture upUpDown[] = { GES_UP, GES_UP, GES_DOWN };
+const Gesture clockwiseWave[] = { GES_CLOCKWISE, GES_WAVE };
+const Gesture upLeft[] = { GES_UP, GES_LEFT };
+
+// Feeds a scripted stream, one gesture every stepMs, returns the last combo seen
+template <uint8_t N>
+int feed(PAJ7620_ComboRecognizer<N> &combos, const Gesture stream[], int length,
+         unsigned long &now, unsigned long stepMs)
+{
+  int found = PAJ7620_COMBO_NONE;
+  for (int i = 0; i < length; i++)
+  {
+    now += stepMs;
+    int8_t id = combos.update(stream[i], now);
+    if (id != PAJ7620_COMBO_NONE)
+      { found = id; }
+  }
+  return found;
+}
+
+unittest(combos_match_in_stream)
+{
+  PAJ7620_ComboRecognizer<> combos;
+  assertEqual(0, combos.addCombo(upUpDown, 3, 1000));
+  assertEqual(1, combos.addCombo(clockwiseWave, 2, 1500));
+  unsigned long now = 0;
+
+  const Gesture stream[] = { GES_LEFT, GES_UP, GES_UP, GES_DOWN };
+  assertEqual(0, feed(combos, stream, 4, now, 300));
+
+  const Gesture other[] = { GES_CLOCKWISE, GES_NONE, GES_WAVE };
+  assertEqual(1, feed(combos, other, 3, now, 400));
+}
+
+unittest(partial_matches_overlap)
+{
+  PAJ7620_ComboRecognizer<> combos;
+  combos.addCombo(upUpDown, 3, 1000);
+  combos.addCombo(upLeft, 2, 1000);
+  unsigned long now = 0;
+
+  // Third UP falls back to the UP-UP prefix instead of starting over
+  const Gesture stream[] = { GES_UP, GES_UP, GES_UP, GES_DOWN };
+  assertEqual(0, feed(combos, stream, 4, now, 100));
+
+  // UP-UP then LEFT completes UP-LEFT through the suffix link
+  const Gesture suffix[] = { GES_UP, GES_UP, GES_LEFT };
+  assertEqual(1, feed(combos, suffix, 3, now, 100));
+}
+
+unittest(step_window_expires)
+{
+  PAJ7620_ComboRecognizer<> combos;
+  combos.addCombo(upUpDown, 3, 500);
+  unsigned long now = 0;
+
+  assertEqual(PAJ7620_COMBO_NONE, combos.update(GES_UP, now += 100));
+  assertEqual(PAJ7620_COMBO_NONE, combos.update(GES_UP, now += 100));
+  assertEqual(PAJ7620_COMBO_NONE, combos.update(GES_DOWN, now += 600));
+
+  // The late DOWN did not count, a fresh try works
+  const Gesture stream[] = { GES_UP, GES_UP, GES_DOWN };
+  assertEqual(0, feed(combos, stream, 3, now, 500));
+}
+
+unittest(gesture_counts_toward_one_combo)
+{
+  PAJ7620_ComboRecognizer<> combos;
+  const Gesture upUp[] = { GES_UP, GES_UP };
+  combos.addCombo(upUp, 2, 1000);
+  unsigned long now = 0;
+  assertEqual(PAJ7620_COMBO_NONE, combos.update(GES_UP, now += 10));
+  assertEqual(0, combos.update(GES_UP, now += 10));
+  assertEqual(PAJ7620_COMBO_NONE, combos.update(GES_UP, now += 10));
+  assertEqual(0, combos.update(GES_UP, now += 10));
+}
+
+unittest(registration_limits)
+{
+  PAJ7620_ComboRecognizer<4> combos;     // Root + 3 nodes
+  const Gesture bad[] = { GES_UP, GES_NONE };
+  assertEqual(PAJ7620_COMBO_NONE, combos.addCombo(bad, 2, 100));
+  assertEqual(0, combos.addCombo(upUpDown, 3, 100));
+  assertEqual(PAJ7620_COMBO_NONE, combos.addCombo(upUpDown, 3, 100));  // Duplicate
+  assertEqual(PAJ7620_COMBO_NONE, combos.addCombo(upLeft, 2, 100));    // No nodes left
+  assertEqual(1, combos.combos());
+
+  combos.update(GES_UP, 0);
+  const Gesture up[] = { GES_UP };
+  assertEqual(PAJ7620_COMBO_NONE, combos.addCombo(up, 1, 100));        // Already built
+}
+
+unittest_main()
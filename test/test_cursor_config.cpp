@@ -0,0 +1,96 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+std::deque<uint8_t> *mosi;
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_LSB);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->setBurstUploads(PAJ7620_BURST_OFF);   // Counts below are per register
+  sensor->begin();
+  mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  mosi->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(defaults_match_cursor_table_and_write_nothing)
+{
+  sensor->setCursorMode();
+  // Table is 2 bytes per entry plus the final bank 0 park - nothing more
+  //  when the config is untouched
+  assertEqual(2 * SET_CURSOR_MODE_REG_ARRAY_SIZE + 2, mosi->size());
+
+  CursorConfig config;
+  sensor->getCursorConfig(config);
+  mosi->clear();
+  assertEqual(1, sensor->applyCursorConfig(config));
+  assertEqual(0, mosi->size());
+}
+
+unittest(invalid_fields_are_rejected)
+{
+  CursorConfig config;
+  sensor->getCursorConfig(config);
+
+  CursorConfig bad = config;
+  bad.clampRight = 0x20;
+  assertEqual(0, sensor->applyCursorConfig(bad));
+  bad = config;
+  bad.clampUp = bad.clampDown;
+  assertEqual(0, sensor->applyCursorConfig(bad));
+  bad = config;
+  bad.positionResolution = 8;
+  assertEqual(0, sensor->applyCursorConfig(bad));
+  bad = config;
+  bad.processFilterStart = 0x200;
+  assertEqual(0, sensor->applyCursorConfig(bad));
+}
+
+unittest(only_changed_registers_are_burst)
+{
+  sensor->setCursorMode();
+  CursorConfig config;
+  sensor->getCursorConfig(config);
+  config.clampLeft = 0x08;
+  config.clampUp = 0x08;              // 0x37 and 0x39 change, 0x38 rides along
+  sensor->setBurstUploads(PAJ7620_BURST_ON);
+  mosi->clear();
+
+  assertEqual(1, sensor->applyCursorConfig(config));
+  assertEqual(4, mosi->size());
+  assertEqual(0x37, mosi->at(0));
+  assertEqual(0x08, mosi->at(1));
+  assertEqual(0x1B, mosi->at(2));
+  assertEqual(0x08, mosi->at(3));
+}
+
+unittest(config_survives_mode_change)
+{
+  CursorConfig config;
+  sensor->getCursorConfig(config);
+  config.positionResolution = 0x04;
+  assertEqual(1, sensor->applyCursorConfig(config));
+  assertEqual(0, mosi->size());       // Deferred in gesture mode
+
+  sensor->setCursorMode();
+  assertEqual(2 * SET_CURSOR_MODE_REG_ARRAY_SIZE + 2 + 2, mosi->size());
+  assertEqual(0x8C, mosi->at(mosi->size() - 2));
+  assertEqual(0x04, mosi->back());
+
+  // Sliced upload re-applies it too
+  mosi->clear();
+  sensor->requestCursorMode();
+  while (sensor->serviceBus(0)) {}
+  assertEqual(0x04, mosi->back());
+}
+
+unittest_main()
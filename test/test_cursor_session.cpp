@@ -0,0 +1,123 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+std::deque<uint8_t> *mosi;
+std::deque<uint8_t> *miso;
+
+// Queue the burst serviceCursorSession() reads: 0x3B..0x44
+void pushCursorBlock(int x, int y, uint8_t flags)
+{
+  uint8_t block[PAJ7620_CURSOR_BLOCK_SIZE] = { 0 };
+  block[0] = x & 0xFF;
+  block[1] = x >> 8;
+  block[2] = y & 0xFF;
+  block[3] = y >> 8;
+  block[PAJ7620_CURSOR_BLOCK_SIZE - 1] = flags;
+  for (int i = 0; i < PAJ7620_CURSOR_BLOCK_SIZE; i++)
+    { miso->push_back(block[i]); }
+}
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->setBurstUploads(PAJ7620_BURST_ON);  // Queued answers are not read backs
+  sensor->begin();
+  mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(start_enters_cursor_mode_and_reads_state)
+{
+  miso->push_back(CUR_NO_OBJECT);
+  assertEqual(1, sensor->startCursorSession());
+  assertEqual(0, miso->size());
+  assertEqual(PAJ7620_ADDR_CURSOR_INT, mosi->back());
+}
+
+unittest(idle_session_does_no_bus_traffic)
+{
+  sensor->setCursorMode();
+  sensor->startCursorSession();
+  mosi->clear();
+
+  int x = -1, y = -1;
+  for (int i = 0; i < 100; i++)
+    { assertEqual(CURSOR_IDLE, sensor->serviceCursorSession(x, y)); }
+  assertEqual(0, mosi->size());
+  assertEqual(-1, x);
+}
+
+unittest(edges_start_and_stop_sampling)
+{
+  sensor->setCursorMode();
+  sensor->startCursorSession();
+  mosi->clear();
+  int x = 0, y = 0;
+
+  sensor->notifyInterrupt();                // Has-object edge
+  pushCursorBlock(0x123, 0x456, CUR_HAS_OBJECT);
+  assertEqual(CURSOR_ENTER, sensor->serviceCursorSession(x, y));
+  assertEqual(0x123, x);
+  assertEqual(0x456, y);
+  assertEqual(1, mosi->size());             // One burst per sample
+  assertEqual(PAJ7620_ADDR_CURSOR_X_LOW, mosi->back());
+
+  // In view: sampled every call, with or without an edge
+  pushCursorBlock(0x124, 0x457, 0x00);
+  assertEqual(CURSOR_MOVE, sensor->serviceCursorSession(x, y));
+  assertEqual(0x124, x);
+  pushCursorBlock(0x125, 0x458, CUR_HAS_OBJECT);
+  assertEqual(CURSOR_MOVE, sensor->serviceCursorSession(x, y));
+  assertEqual(0x458, y);
+
+  sensor->notifyInterrupt();                // No-object edge
+  pushCursorBlock(0, 0, CUR_NO_OBJECT);
+  assertEqual(CURSOR_EXIT, sensor->serviceCursorSession(x, y));
+  assertEqual(0x125, x);                    // Left alone on exit
+
+  mosi->clear();
+  assertEqual(CURSOR_IDLE, sensor->serviceCursorSession(x, y));
+  assertEqual(0, mosi->size());
+}
+
+unittest(object_already_in_view_is_tracked)
+{
+  miso->push_back(CUR_HAS_OBJECT | 0x01);   // Extra bits do not hide it
+  sensor->startCursorSession();
+  int x = 0, y = 0;
+  pushCursorBlock(0x010, 0x020, CUR_HAS_OBJECT);
+  assertEqual(CURSOR_MOVE, sensor->serviceCursorSession(x, y));
+  assertEqual(0x010, x);
+}
+
+unittest(in_view_decoded_bitwise)
+{
+  sensor->setCursorMode();
+  miso->push_back(CUR_HAS_OBJECT | 0x01);
+  assertTrue(sensor->isCursorInView());
+  miso->push_back(CUR_NO_OBJECT);
+  assertFalse(sensor->isCursorInView());
+}
+
+unittest(gesture_mode_ends_session)
+{
+  sensor->startCursorSession();
+  sensor->setGestureMode();
+  mosi->clear();
+  int x = 0, y = 0;
+  sensor->notifyInterrupt();
+  assertEqual(CURSOR_IDLE, sensor->serviceCursorSession(x, y));
+  assertEqual(0, mosi->size());
+}
+
+unittest_main()
@@ -0,0 +1,65 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+GestureTraceEntry trace[2];
+
+unittest_setup()
+{
+  GODMODE()->reset();
+  Wire.resetMocks();
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_LSB);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->begin();
+  sensor->enableGestureTrace(trace, 2);
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(forward_after_lateral_records_all_stages)
+{
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(GES_RIGHT_FLAG);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(GES_FORWARD_FLAG);
+  sensor->notifyInterrupt();
+
+  assertEqual(GES_FORWARD, sensor->readGesture());
+  assertEqual(GES_FORWARD, trace[0].gesture);
+  assertLessOrEqual(trace[0].stageTime[TRACE_INTERRUPT], trace[0].stageTime[TRACE_FLAG_READ]);
+  assertLessOrEqual(trace[0].stageTime[TRACE_FLAG_READ], trace[0].stageTime[TRACE_CHECK]);
+  // Exit time (200ms default) sits between the check and the return
+  assertMoreOrEqual(trace[0].stageTime[TRACE_RETURN] - trace[0].stageTime[TRACE_CHECK], 200000);
+}
+
+unittest(no_gesture_is_not_recorded)
+{
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(0x00);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(0x00);
+  assertEqual(GES_NONE, sensor->readGesture());
+
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(GES_CLOCKWISE_FLAG);
+  assertEqual(GES_CLOCKWISE, sensor->readGesture());
+  assertEqual(GES_CLOCKWISE, trace[0].gesture);
+  assertEqual(0, trace[0].stageTime[TRACE_INTERRUPT]);
+  assertEqual(0, trace[0].stageTime[TRACE_CHECK]);
+}
+
+unittest(edge_without_gesture_is_not_charged_to_next_gesture)
+{
+  // Hand left without a gesture: INT edge, then nothing flagged
+  sensor->notifyInterrupt();
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(0x00);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(0x00);
+  assertEqual(GES_NONE, sensor->readGesture());
+
+  GODMODE()->micros += 3000000;
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(GES_CLOCKWISE_FLAG);
+  assertEqual(GES_CLOCKWISE, sensor->readGesture());
+  assertEqual(0, trace[0].stageTime[TRACE_INTERRUPT]);
+}
+
+unittest_main()
@@ -0,0 +1,121 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+std::deque<uint8_t> *mosi;
+std::deque<uint8_t> *miso;
+
+unittest_setup()
+{
+  GODMODE()->reset();
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->begin();
+  mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  mosi->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(healthy_sensor_is_one_read)
+{
+  miso->push_back(0x01);            // Canary as written by the init array
+  assertEqual(1, sensor->checkHealth());
+  assertEqual(1, mosi->size());
+  assertEqual(PAJ7620_ADDR_HEALTH_CANARY, mosi->at(0));
+
+  HealthStats stats;
+  sensor->getHealthStats(stats);
+  assertEqual(1, stats.checks);
+  assertEqual(0, stats.resets);
+}
+
+unittest(reset_sensor_is_reinitialized)
+{
+  CursorConfig config;
+  sensor->setCursorMode();
+  sensor->getCursorConfig(config);
+  config.objectSizeThreshold = 0x05;
+  sensor->applyCursorConfig(config);
+  sensor->disable();
+  mosi->clear();
+
+  miso->push_back(PAJ7620_HEALTH_CANARY_RESET);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  assertEqual(1, sensor->checkHealth());
+
+  // Init array, cursor array and config all went out again, disable() last
+  //  (every table entry is at least its value byte once runs are burst)
+  assertMoreOrEqual(mosi->size(), INIT_REG_ARRAY_SIZE + SET_CURSOR_MODE_REG_ARRAY_SIZE);
+  assertEqual(PAJ7620_DISABLE, mosi->at(mosi->size() - 3));
+
+  HealthStats stats;
+  sensor->getHealthStats(stats);
+  assertEqual(1, stats.resets);
+  assertEqual(1, stats.recoveries);
+
+  // The re-applied config is the new canary value
+  miso->push_back(0x05);
+  assertEqual(1, sensor->checkHealth());
+  sensor->getHealthStats(stats);
+  assertEqual(1, stats.resets);
+}
+
+unittest(wrong_device_is_not_reinitialized)
+{
+  miso->push_back(PAJ7620_HEALTH_CANARY_RESET);
+  miso->push_back(0x00);
+  miso->push_back(0x00);
+  assertEqual(0, sensor->checkHealth());
+
+  HealthStats stats;
+  sensor->getHealthStats(stats);
+  assertEqual(1, stats.resets);
+  assertEqual(0, stats.recoveries);
+}
+
+unittest(missing_sensor_counts_bus_errors)
+{
+  // Replaying an empty trace makes every transaction fail, like a NACK
+  uint8_t empty[1] = { 0 };
+  PAJ7620_I2CTrace trace;
+  trace.beginReplay(empty, 0);
+  sensor->setI2CTrace(&trace);
+
+  assertEqual(0, sensor->checkHealth());
+  HealthStats stats;
+  sensor->getHealthStats(stats);
+  assertEqual(1, stats.busErrors);
+
+  sensor->setI2CTrace(NULL);
+  sensor->clearHealthStats();
+  sensor->getHealthStats(stats);
+  assertEqual(0, stats.checks);
+}
+
+unittest(automatic_checks_follow_interval)
+{
+  sensor->setHealthCheckInterval(5000);
+  sensor->readGesture();
+  HealthStats stats;
+  sensor->getHealthStats(stats);
+  assertEqual(0, stats.checks);
+
+  GODMODE()->micros += 5000000UL;
+  mosi->clear();
+  miso->push_back(0x01);
+  sensor->readGesture();
+  assertEqual(PAJ7620_ADDR_HEALTH_CANARY, mosi->at(0));
+  sensor->getHealthStats(stats);
+  assertEqual(1, stats.checks);
+}
+
+unittest_main()
@@ -0,0 +1,99 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+uint8_t traceBuffer[1024];
+
+// Runs a short session: init, a few gesture polls and a cursor read
+void runSession(RevEng_PAJ7620 &sensor, Gesture results[3], int &cursorX)
+{
+  sensor.setBurstUploads(PAJ7620_BURST_ON);   // Queued answers are not read backs
+  sensor.begin();
+  results[0] = sensor.readGesture();
+  results[1] = sensor.readGesture();
+  results[2] = sensor.readGesture();
+  sensor.setCursorMode();
+  cursorX = sensor.getCursorX();
+}
+
+unittest_setup()
+{
+  GODMODE()->reset();
+  Wire.resetMocks();
+}
+
+unittest(recorded_session_replays_without_bus)
+{
+  std::deque<uint8_t> *miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  miso->push_back(GES_CLOCKWISE_FLAG);
+  miso->push_back(GES_UP_FLAG);         // Lateral gesture ...
+  miso->push_back(GES_BACKWARD_FLAG);   // ... followed up by backward
+  miso->push_back(0x00);                // Nothing in reg 0 ...
+  miso->push_back(GES_WAVE_FLAG);       // ... wave in reg 1
+  miso->push_back(0x34);                // Cursor X low
+  miso->push_back(0x02);                // Cursor X high
+
+  PAJ7620_I2CTrace recorder;
+  recorder.beginRecording(traceBuffer, sizeof(traceBuffer));
+  RevEng_PAJ7620 live;
+  live.setI2CTrace(&recorder);
+  Gesture liveResults[3];
+  int liveX = 0;
+  runSession(live, liveResults, liveX);
+  recorder.stop();
+
+  assertFalse(recorder.overflowed());
+  assertEqual(GES_CLOCKWISE, liveResults[0]);
+  assertEqual(GES_BACKWARD, liveResults[1]);
+  assertEqual(GES_WAVE, liveResults[2]);
+  assertEqual(0x234, liveX);
+
+  // Replay with an empty bus: every answer must come from the trace
+  Wire.resetMocks();
+  PAJ7620_I2CTrace player;
+  player.beginReplay(traceBuffer, recorder.length());
+  RevEng_PAJ7620 replayed;
+  replayed.setI2CTrace(&player);
+  Gesture replayResults[3];
+  int replayX = 0;
+  runSession(replayed, replayResults, replayX);
+
+  assertEqual(0, player.mismatches());
+  assertTrue(player.replayFinished());
+  for (int i = 0; i < 3; i++)
+    { assertEqual(liveResults[i], replayResults[i]); }
+  assertEqual(liveX, replayX);
+  assertEqual(0, Wire.getMosi(PAJ7620_I2C_BUS_ADDR)->size());
+}
+
+unittest(diverging_driver_is_flagged)
+{
+  const uint8_t trace[] = { 0x01, PAJ7620_REGISTER_BANK_SEL, 0x00, PAJ7620_BANK1 };
+  PAJ7620_I2CTrace player;
+  player.beginReplay(trace, sizeof(trace));
+  RevEng_PAJ7620 sensor;
+  sensor.setI2CTrace(&player);
+  sensor.disable();                     // Selects bank 1 as recorded, then diverges
+
+  assertMore(player.mismatches(), 0);
+}
+
+unittest(backwards_clock_keeps_delta_at_32_bits)
+{
+  PAJ7620_I2CTrace recorder;
+  recorder.beginRecording(traceBuffer, sizeof(traceBuffer));
+  uint8_t value = 0x5A;
+  recorder.recordTransaction(false, 0x41, 1, &value, 1000);
+  recorder.recordTransaction(false, 0x42, 1, &value, 10);   // Clock went back
+
+  // 4 byte first record, then header, address, 5 byte varint and data
+  assertEqual(4 + 2 + 5 + 1, recorder.length());
+  uint32_t delta = 0;
+  for (int i = 0; i < 5; i++)
+    { delta |= (uint32_t)(traceBuffer[4 + 2 + i] & 0x7F) << (7 * i); }
+  assertEqual((uint32_t)(10 - 1000), delta);
+  assertEqual(0, traceBuffer[4 + 2 + 4] & 0x80);
+}
+
+unittest_main()
@@ -0,0 +1,107 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+std::deque<uint8_t> *mosi;
+std::deque<uint8_t> *miso;
+
+unittest_setup()
+{
+  GODMODE()->reset();
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->begin();
+  mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  mosi->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(invert_uses_cached_lens)
+{
+  sensor->invertXAxis();
+  // Bank 1, lens = gesture table's 0x02 with X flipped, park in bank 0 - no read
+  assertEqual(6, mosi->size());
+  assertEqual(PAJ7620_ADDR_LENS_ORIENTATION, mosi->at(2));
+  assertEqual(0x03, mosi->at(3));
+  assertEqual(0, miso->size());
+}
+
+unittest(invert_survives_mode_change)
+{
+  sensor->invertXAxis();
+  mosi->clear();
+  sensor->setCursorMode();
+  // Cursor table writes 0x03, then the X inversion goes back on top
+  assertEqual(PAJ7620_BANK0, mosi->back());
+  assertEqual(0x02, mosi->at(mosi->size() - 3));
+  assertEqual(PAJ7620_ADDR_LENS_ORIENTATION, mosi->at(mosi->size() - 4));
+}
+
+unittest(software_orientation_is_bus_free)
+{
+  assertEqual(1, sensor->setOrientation(90, false));
+  assertEqual(0, mosi->size());
+
+  int x = 0x100, y = 0x200;
+  sensor->orientCursor(x, y);
+  assertEqual(PAJ7620_CURSOR_MAX - 0x200, x);
+  assertEqual(0x100, y);
+
+  assertEqual(1, sensor->setOrientation(270, true));
+  x = 0x100; y = 0x200;
+  sensor->orientCursor(x, y);       // Mirror to 0xEFF, then rotate
+  assertEqual(0x200, x);
+  assertEqual(PAJ7620_CURSOR_MAX - 0xEFF, y);
+}
+
+unittest(cursor_read_is_one_oriented_burst)
+{
+  sensor->setOrientation(180, false);
+  miso->push_back(0x34);    // X low
+  miso->push_back(0x02);    // X high
+  miso->push_back(0x56);    // Y low
+  miso->push_back(0x01);    // Y high
+  assertEqual(PAJ7620_CURSOR_MAX - 0x234, sensor->getCursorX());
+  assertEqual(1, mosi->size());
+  assertEqual(PAJ7620_ADDR_CURSOR_X_LOW, mosi->at(0));
+}
+
+unittest(gestures_follow_rotation)
+{
+  sensor->setOrientation(90, false);
+  assertEqual(GES_RIGHT, sensor->orientGesture(GES_UP));
+  assertEqual(GES_UP, sensor->orientGesture(GES_LEFT));
+  assertEqual(GES_WAVE, sensor->orientGesture(GES_WAVE));
+
+  sensor->setOrientation(0, true);
+  assertEqual(GES_LEFT, sensor->orientGesture(GES_RIGHT));
+  assertEqual(GES_ANTICLOCKWISE, sensor->orientGesture(GES_CLOCKWISE));
+
+  sensor->setOrientation(90, false);
+  miso->push_back(GES_UP_FLAG);
+  assertEqual(GES_RIGHT, sensor->readGesture());
+}
+
+unittest(lens_orientation_is_absolute)
+{
+  assertEqual(0, sensor->setOrientation(90, false, true));   // Lens cannot rotate
+  assertEqual(0, sensor->setOrientation(45, false));
+
+  sensor->invertYAxis();
+  mosi->clear();
+  assertEqual(1, sensor->setOrientation(180, false, true));
+  assertEqual(0x02 ^ 0x03, mosi->at(3));                    // Not 0x02 ^ 0x02 ^ 0x03
+  mosi->clear();
+  assertEqual(1, sensor->setOrientation(0, false));         // Back to the table lens
+  assertEqual(0x02, mosi->at(3));
+}
+
+unittest_main()
@@ -0,0 +1,90 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+std::deque<uint8_t> *mosi;
+std::deque<uint8_t> *miso;
+
+// Queue the two bursts poll() reads: 0x3B..0x45 then 0xAC..0xB7
+void pushPollData(int x, int y, uint8_t flags0, uint8_t flags1, uint8_t waves)
+{
+  uint8_t status[PAJ7620_STATUS_BLOCK_SIZE] = { 0 };
+  status[0] = x & 0xFF;
+  status[1] = x >> 8;
+  status[2] = y & 0xFF;
+  status[3] = y >> 8;
+  status[8] = flags0;
+  status[9] = flags1;
+  status[10] = 0x01;
+  for (int i = 0; i < PAJ7620_STATUS_BLOCK_SIZE; i++)
+    { miso->push_back(status[i]); }
+  for (int i = 0; i < PAJ7620_OBJECT_BLOCK_SIZE; i++)
+    { miso->push_back(i == PAJ7620_OBJECT_BLOCK_SIZE - 1 ? waves : 0x00); }
+}
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->begin();
+  mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  mosi->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(poll_is_two_bursts)
+{
+  SensorSnapshot snap;
+  pushPollData(0, 0, GES_LEFT_FLAG, 0x00, 0x05);
+  assertEqual(1, sensor->poll(snap));
+
+  assertEqual(2, mosi->size());
+  assertEqual(PAJ7620_ADDR_CURSOR_X_LOW, mosi->at(0));
+  assertEqual(PAJ7620_ADDR_OBJECT_CENTER_X_LOW, mosi->at(1));
+  assertEqual(0, miso->size());
+
+  assertEqual(GES_LEFT, snap.gesture);
+  assertEqual(0x01, snap.state);
+  assertEqual(5, snap.object.waveCount);
+  assertFalse(snap.cursorInView);
+}
+
+unittest(poll_decodes_wave_from_second_flag_register)
+{
+  SensorSnapshot snap;
+  pushPollData(0, 0, 0x00, GES_WAVE_FLAG, 0x00);
+  sensor->poll(snap);
+  assertEqual(GES_WAVE, snap.gesture);
+}
+
+unittest(getters_answer_from_snapshot)
+{
+  sensor->setCursorMode();
+  SensorSnapshot snap;
+  pushPollData(0x234, 0x156, 0x00, CUR_HAS_OBJECT, 0x03);
+  sensor->poll(snap);
+  assertEqual(GES_NONE, snap.gesture);
+  assertTrue(snap.cursorInView);
+
+  sensor->setSnapshotReads(true);
+  mosi->clear();
+  assertTrue(sensor->isCursorInView());
+  assertEqual(0x234, sensor->getCursorX());
+  assertEqual(0x156, sensor->getCursorY());
+  assertEqual(3, sensor->getWaveCount());
+  assertEqual(0, mosi->size());
+
+  sensor->setSnapshotReads(false);
+  sensor->getWaveCount();
+  assertEqual(1, mosi->size());
+}
+
+unittest_main()
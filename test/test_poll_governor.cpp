@@ -0,0 +1,116 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+#include "RevEng_PAJ7620_PollGovernor.h"
+
+RevEng_PAJ7620 *sensor;
+
+unittest_setup()
+{
+  GODMODE()->reset();
+  Wire.resetMocks();
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_LSB);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->begin();
+  Wire.getMosi(PAJ7620_I2C_BUS_ADDR)->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(idle_backs_off_to_max)
+{
+  PAJ7620_PollGovernor governor(20, 640);
+  assertEqual(20, governor.interval());
+  assertEqual(40, governor.update(false));
+  assertEqual(80, governor.update(false));
+  for (int i = 0; i < 10; i++)
+    { governor.update(false); }
+  assertEqual(640, governor.interval());
+  assertEqual(20, governor.update(true));
+}
+
+unittest(idle_sensor_is_polled_an_order_of_magnitude_less)
+{
+  PAJ7620_PollGovernor governor(20, 640);
+  // Loop spins every ms for 10 simulated seconds with nothing in view
+  for (int ms = 0; ms < 10000; ms++)
+  {
+    assertEqual(GES_NONE, governor.pollGesture(*sensor));
+    GODMODE()->micros += 1000;
+  }
+  // A fixed 50ms poll would have made 200 polls
+  assertLess(governor.pollCount(), 25);
+  assertLess(governor.timeUntilDue(), 641);
+}
+
+unittest(state_indicator_restores_fast_polling)
+{
+  PAJ7620_PollGovernor governor(20, 640);
+  for (int i = 0; i < 8; i++)
+    { governor.update(false); }
+  GODMODE()->micros += 640000UL;
+
+  std::deque<uint8_t> *miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(0x00);          // 0x43 - no gesture flags
+  miso->push_back(0x00);          // 0x44 - no wave
+  miso->push_back(0x01);          // 0x45 - engine busy
+  assertEqual(GES_NONE, governor.pollGesture(*sensor));
+  assertEqual(20, governor.interval());
+  assertEqual(0, miso->size());
+}
+
+unittest(idle_poll_is_one_transaction)
+{
+  PAJ7620_PollGovernor governor(20, 640);
+  std::deque<uint8_t> *miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(0x00);          // 0x43
+  miso->push_back(0x00);          // 0x44
+  miso->push_back(0x00);          // 0x45
+  assertEqual(GES_NONE, governor.pollGesture(*sensor));
+  assertEqual(40, governor.interval());
+
+  // Only the address of the burst read went out
+  std::deque<uint8_t> *mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  assertEqual(1, mosi->size());
+  assertEqual(PAJ7620_ADDR_GES_RESULT_0, mosi->front());
+}
+
+unittest(burst_flags_still_run_the_gesture_path)
+{
+  PAJ7620_PollGovernor governor(20, 640);
+  std::deque<uint8_t> *miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(0x00);          // 0x43
+  miso->push_back(GES_WAVE_FLAG); // 0x44
+  miso->push_back(0x00);          // 0x45
+  assertEqual(GES_WAVE, governor.pollGesture(*sensor));
+  assertEqual(20, governor.interval());
+}
+
+unittest(cursor_mode_reports_object_bit)
+{
+  sensor->setCursorMode();
+  std::deque<uint8_t> *miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(CUR_HAS_OBJECT | 0x01);   // 0x44 - other bits set too
+  miso->push_back(0x00);                    // 0x45
+  assertEqual(PAJ7620_ACTIVITY_OBJECT, sensor->readActivity());
+
+  miso->push_back(CUR_NO_OBJECT);
+  miso->push_back(0x00);
+  assertEqual(0, sensor->readActivity());
+}
+
+unittest(wake_forces_next_poll)
+{
+  PAJ7620_PollGovernor governor(20, 640);
+  governor.pollActivity(*sensor);
+  assertFalse(governor.isDue());
+  governor.wake();
+  assertTrue(governor.isDue());
+  assertEqual(0, governor.timeUntilDue());
+}
+
+unittest_main()
@@ -0,0 +1,119 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+std::deque<uint8_t> *mosi;
+std::deque<uint8_t> *miso;
+
+unittest_setup()
+{
+  GODMODE()->reset();
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->begin();
+  mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  mosi->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+// Threshold burst is the last transaction: 0x69, high, low
+void assertThresholdsWritten(uint8_t high, uint8_t low)
+{
+  size_t n = mosi->size();
+  assertEqual(PAJ7620_ADDR_PS_HIGH_THRESHOLD, mosi->at(n - 3));
+  assertEqual(high, mosi->at(n - 2));
+  assertEqual(low, mosi->at(n - 1));
+}
+
+unittest(quiet_site_uses_minimum_margin)
+{
+  miso->push_back(0x03);                        // Current gain
+  for (int i = 0; i < 8; i++)
+    { miso->push_back(i % 2 ? 41 : 39); }       // Mean 40, noise 1
+
+  ProximityCalibration cal;
+  assertEqual(1, sensor->calibrateProximity(cal, 8, 5));
+  assertEqual(PAJ7620_PS_CAL_MARKER, cal.marker);
+  assertEqual(40, cal.ambientMean);
+  assertEqual(1, cal.ambientNoise);
+  assertEqual(40 + PAJ7620_PS_MIN_MARGIN, cal.highThreshold);
+  assertEqual(40 + PAJ7620_PS_MIN_MARGIN / 2, cal.lowThreshold);
+  assertEqual(0x03, cal.gain);
+  assertThresholdsWritten(56, 48);
+}
+
+unittest(noisy_site_widens_margin)
+{
+  miso->push_back(0x03);
+  for (int i = 0; i < 8; i++)
+    { miso->push_back(i % 2 ? 110 : 90); }      // Mean 100, noise 10
+
+  ProximityCalibration cal;
+  assertEqual(1, sensor->calibrateProximity(cal, 8, 5));
+  assertEqual(10, cal.ambientNoise);
+  assertEqual(140, cal.highThreshold);
+  assertEqual(120, cal.lowThreshold);
+}
+
+unittest(bright_site_lowers_gain)
+{
+  miso->push_back(0x03);
+  for (int i = 0; i < 8; i++)
+    { miso->push_back(250); }                   // No room at gain 3
+  for (int i = 0; i < 8; i++)
+    { miso->push_back(120); }                   // Fits at gain 2
+
+  ProximityCalibration cal;
+  assertEqual(1, sensor->calibrateProximity(cal, 8, 5));
+  assertEqual(0x02, cal.gain);
+  assertEqual(120, cal.ambientMean);
+}
+
+unittest(saturated_at_lowest_gain_fails)
+{
+  miso->push_back(0x00);
+  for (int i = 0; i < 8; i++)
+    { miso->push_back(0xFF); }
+
+  ProximityCalibration cal;
+  assertEqual(0, sensor->calibrateProximity(cal, 8, 5));
+}
+
+unittest(failed_calibration_restores_entry_gain)
+{
+  miso->push_back(0x01);                        // Current gain
+  for (int i = 0; i < 16; i++)
+    { miso->push_back(0xFF); }                  // Saturated at gains 1 and 0
+
+  ProximityCalibration cal;
+  assertEqual(0, sensor->calibrateProximity(cal, 8, 5));
+
+  // Last gain write, in bank 1, puts back the entry value
+  size_t n = mosi->size();
+  assertEqual(PAJ7620_ADDR_PS_GAIN, mosi->at(n - 4));
+  assertEqual(0x01, mosi->at(n - 3));
+  assertEqual(PAJ7620_REGISTER_BANK_SEL, mosi->at(n - 2));
+  assertEqual(PAJ7620_BANK0, mosi->at(n - 1));
+}
+
+unittest(stored_calibration_restores_without_sampling)
+{
+  ProximityCalibration cal = { PAJ7620_PS_CAL_MARKER, 90, 70, 0x02, 60, 3 };
+  assertEqual(1, sensor->applyProximityCalibration(cal));
+  assertEqual(0, miso->size());
+  assertThresholdsWritten(90, 70);
+
+  ProximityCalibration blank;
+  memset(&blank, 0xFF, sizeof(blank));          // Erased EEPROM
+  assertEqual(0, sensor->applyProximityCalibration(blank));
+}
+
+unittest_main()
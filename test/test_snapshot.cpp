@@ -0,0 +1,161 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+
+class CaptureOutput : public Print
+{
+  public:
+    char text[1024];
+    size_t count = 0;
+    size_t write(uint8_t data) { if (count < sizeof(text) - 1) { text[count++] = data; text[count] = 0; } return 1; }
+};
+
+// Offsets of bank 1 0x04 (lens) and 0x74 (mode select) in a RegisterSnapshot
+#define SNAP_LENS_OFFSET    44
+#define SNAP_MODE_OFFSET    66
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_LSB);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->begin();
+  Wire.getMosi(PAJ7620_I2C_BUS_ADDR)->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(snapshot_ranges_fill_snapshot)
+{
+  int total = 0;
+  for (unsigned int i = 0; i < SNAPSHOT_RANGE_ARRAY_SIZE; i++)
+  {
+    if ((snapshotRegisterRanges[i] >> 8) != PAJ7620_REGISTER_BANK_SEL)
+      { total += snapshotRegisterRanges[i] & 0xFF; }
+  }
+  assertEqual(PAJ7620_SNAPSHOT_SIZE, total);
+}
+
+unittest(restore_writes_one_burst_per_run)
+{
+  RegisterSnapshot snap;
+  for (int i = 0; i < PAJ7620_SNAPSHOT_SIZE; i++)
+    { snap.values[i] = i; }
+
+  assertEqual(1, sensor->restore(snap));
+
+  std::deque<uint8_t> *mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  // Bank 0 select, then first run 0x32..0x3A carrying values 0..8
+  assertEqual(PAJ7620_REGISTER_BANK_SEL, mosi->at(0));
+  assertEqual(PAJ7620_BANK0, mosi->at(1));
+  assertEqual(0x32, mosi->at(2));
+  for (int i = 0; i < 9; i++)
+    { assertEqual(i, mosi->at(3 + i)); }
+
+  // 4 bank selects (incl. final park) + one address byte per run + data
+  unsigned int runs = SNAPSHOT_RANGE_ARRAY_SIZE - 3;
+  assertEqual(4 * 2 + runs + PAJ7620_SNAPSHOT_SIZE, mosi->size());
+}
+
+unittest(snapshot_reads_one_burst_per_run)
+{
+  std::deque<uint8_t> *miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  std::deque<uint8_t> *mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  for (int i = 0; i < PAJ7620_SNAPSHOT_SIZE; i++)
+    { miso->push_back(i); }
+
+  RegisterSnapshot snap;
+  assertEqual(1, sensor->snapshot(snap));
+  for (int i = 0; i < PAJ7620_SNAPSHOT_SIZE; i++)
+    { assertEqual(i, snap.values[i]); }
+  assertEqual(0, miso->size());
+
+  // Bank 0 select, then the first address of each run: one read per run
+  assertEqual(PAJ7620_REGISTER_BANK_SEL, mosi->at(0));
+  assertEqual(PAJ7620_BANK0, mosi->at(1));
+  assertEqual(0x32, mosi->at(2));
+  assertEqual(0x41, mosi->at(3));
+  unsigned int runs = SNAPSHOT_RANGE_ARRAY_SIZE - 3;
+  assertEqual(4 * 2 + runs, mosi->size());
+
+  // Bank 1 runs come after the second bank select
+  assertEqual(PAJ7620_REGISTER_BANK_SEL, mosi->at(2 + 17));
+  assertEqual(PAJ7620_BANK1, mosi->at(2 + 17 + 1));
+  assertEqual(0x01, mosi->at(2 + 17 + 2));
+}
+
+unittest(snapshot_prints_in_register_dump_format)
+{
+  RegisterSnapshot snap;
+  for (int i = 0; i < PAJ7620_SNAPSHOT_SIZE; i++)
+    { snap.values[i] = i; }
+
+  CaptureOutput out;
+  sensor->printSnapshot(out, snap);
+  assertEqual(0, strcmp(out.text,
+    "PAJ7620 REGS BEGIN\r\n"
+    "B0 32: 00 01 02 03 04 05 06 07 08\r\n"
+    "B0 41: 09 0A\r\n"
+    "B0 46: 0B 0C 0D 0E 0F\r\n"
+    "B0 4C: 10\r\n"
+    "B0 51: 11\r\n"
+    "B0 5E: 12\r\n"
+    "B0 60: 13\r\n"
+    "B0 69: 14 15\r\n"
+    "B0 80: 16 17 18 19\r\n"
+    "B0 8B: 1A 1B\r\n"
+    "B0 90: 1C\r\n"
+    "B0 95: 1D 1E 1F\r\n"
+    "B0 9A: 20\r\n"
+    "B0 9C: 21\r\n"
+    "B0 9F: 22\r\n"
+    "B0 A5: 23\r\n"
+    "B0 CC: 24 25 26 27 28\r\n"
+    "B1 01: 29 2A 2B 2C\r\n"
+    "B1 25: 2D\r\n"
+    "B1 27: 2E 2F 30\r\n"
+    "B1 3E: 31\r\n"
+    "B1 41: 32\r\n"
+    "B1 43: 33 34\r\n"
+    "B1 5E: 35\r\n"
+    "B1 65: 36 37 38 39 3A 3B 3C 3D 3E 3F\r\n"
+    "B1 72: 40 41 42\r\n"
+    "B1 77: 43\r\n"
+    "PAJ7620 REGS END\r\n"));
+}
+
+unittest(restore_refreshes_lens_and_mode)
+{
+  RegisterSnapshot snap;
+  memset(snap.values, 0, sizeof(snap.values));
+  snap.values[SNAP_LENS_OFFSET] = 0x01;     // Init array leaves 0x02
+  snap.values[SNAP_MODE_OFFSET] = PAJ7620_MODE_CURSOR;
+  assertEqual(1, sensor->restore(snap));
+
+  // Flip builds on the restored lens, not the one the init array left
+  std::deque<uint8_t> *mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  mosi->clear();
+  sensor->invertXAxis();
+  assertEqual(6, mosi->size());
+  assertEqual(PAJ7620_ADDR_LENS_ORIENTATION, mosi->at(2));
+  assertEqual(0x00, mosi->at(3));
+
+  // A cursor session only uploads the cursor table if the restored mode
+  //  was gesture mode
+  mosi->clear();
+  sensor->startCursorSession();
+  assertEqual(1, mosi->size());       // Just the interrupt flag read
+  snap.values[SNAP_MODE_OFFSET] = PAJ7620_MODE_GESTURE;
+  assertEqual(1, sensor->restore(snap));
+  mosi->clear();
+  sensor->startCursorSession();
+  assertMore(mosi->size(), SET_CURSOR_MODE_REG_ARRAY_SIZE);
+}
+
+unittest_main()
@@ -0,0 +1,55 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620_Stream.h"
+
+// Collects frames written by the stream
+class CaptureOutput : public Print
+{
+  public:
+    uint8_t bytes[64];
+    size_t count = 0;
+    size_t write(uint8_t data) { if (count < sizeof(bytes)) { bytes[count++] = data; } return 1; }
+};
+
+unittest(crc8_matches_reference)
+{
+  // CRC-8/SMBUS check value for "123456789"
+  const char *check = "123456789";
+  uint8_t crc = 0;
+  for (int i = 0; i < 9; i++)
+    { crc = PAJ7620_Stream::crc8(crc, check[i]); }
+  assertEqual(0xF4, crc);
+}
+
+// Same golden bytes are checked by scripts/test_paj7620_stream.py
+unittest(cursor_key_then_delta_then_gesture)
+{
+  CaptureOutput out;
+  PAJ7620_Stream stream(out);
+  stream.writeCursor(0x234, 0x156);
+  stream.writeCursor(0x230, 0x160);
+  stream.writeNoObject();
+  stream.writeGesture(GES_WAVE);
+
+  const uint8_t expected[] = {
+    0xA5, 0x01, 0x00, 0x34, 0x02, 0x56, 0x01, 0x7B,
+    0xA5, 0x02, 0x01, 0xFC, 0x0A, 0x99,
+    0xA5, 0x03, 0x02, 0x31,
+    0xA5, 0x04, 0x03, 0x09, 0xAB,
+  };
+  assertEqual(sizeof(expected), out.count);
+  for (size_t i = 0; i < sizeof(expected) && i < out.count; i++)
+    { assertEqual(expected[i], out.bytes[i]); }
+  assertEqual(4, stream.sequence());
+}
+
+unittest(large_jump_sends_key_frame)
+{
+  CaptureOutput out;
+  PAJ7620_Stream stream(out);
+  stream.writeCursor(0, 0);
+  stream.writeCursor(500, 0);
+  assertEqual(16, out.count);                       // Two 8 byte key frames
+  assertEqual(PAJ7620_FRAME_CURSOR_KEY, out.bytes[9]);
+}
+
+unittest_main()
@@ -0,0 +1,165 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620_Swipe.h"
+
+// Synthetic trajectory: straight line at a constant speed, sampled every
+// 10ms with deterministic +-jitter, then the hand leaves the view
+struct Trajectory {
+  int x, y;                 // Start
+  long vx, vy;              // Cursor counts per second
+  unsigned long lengthMs;   // Time in view
+  int jitter;
+};
+
+struct Result {
+  Gesture gesture;
+  unsigned long latency;    // ms from entering the view to recognition
+  uint8_t detections;
+};
+
+static Result run(PAJ7620_SwipeRecognizer &swipe, const Trajectory &t,
+                  unsigned long start = 1000)
+{
+  Result r = {GES_NONE, 0, 0};
+  unsigned int seed = 12345;
+  for (unsigned long ms = 0; ms <= t.lengthMs; ms += 10)
+  {
+    seed = seed * 1103515245 + 12345;
+    int noise = t.jitter ? (int)((seed >> 16) % (2 * t.jitter + 1)) - t.jitter : 0;
+    int x = t.x + (int)(t.vx * (long)ms / 1000) + noise;
+    int y = t.y + (int)(t.vy * (long)ms / 1000) - noise;
+    Gesture g = swipe.update(true, x, y, start + ms);
+    if (g != GES_NONE)
+    {
+      if (!r.detections)
+        { r.gesture = g; r.latency = ms; }
+      r.detections++;
+    }
+  }
+  swipe.update(false, 0, 0, start + t.lengthMs + 10);
+  return r;
+}
+
+unittest(directions)
+{
+  PAJ7620_SwipeRecognizer swipe;
+  Trajectory right = {300, 2000, 12000, 0, 300, 0};
+  Trajectory left = {3700, 2000, -12000, 0, 300, 0};
+  Trajectory down = {2000, 300, 0, 12000, 300, 0};
+  Trajectory up = {2000, 3700, 0, -12000, 300, 0};
+  assertEqual(GES_RIGHT, run(swipe, right).gesture);
+  assertEqual(GES_LEFT, run(swipe, left).gesture);
+  assertEqual(GES_DOWN, run(swipe, down).gesture);
+  assertEqual(GES_UP, run(swipe, up).gesture);
+}
+
+unittest(latency_and_measurements)
+{
+  PAJ7620_SwipeRecognizer swipe;
+  Trajectory fast = {300, 2000, 16000, 0, 250, 0};
+  Result r = run(swipe, fast);
+  assertEqual(GES_RIGHT, r.gesture);
+  // 800 counts at 16000/s = 50ms, well inside the sensor's gesture exit time
+  assertEqual(50UL, r.latency);
+  assertEqual(1, r.detections);             // Once per pass
+
+  SwipeInfo info;
+  swipe.getLastSwipe(info);
+  assertEqual(GES_RIGHT, info.gesture);
+  assertEqual(800, info.distance);
+  assertEqual(16000, info.speed);
+  assertEqual(50, info.duration);
+}
+
+unittest(accuracy_with_jitter)
+{
+  PAJ7620_SwipeRecognizer swipe;
+  const Gesture expected[] = {GES_RIGHT, GES_LEFT, GES_DOWN, GES_UP};
+  const long dirX[] = {1, -1, 0, 0};
+  const long dirY[] = {0, 0, 1, -1};
+  unsigned int correct = 0, total = 0;
+  unsigned long worst = 0;
+  unsigned long start = 1000;
+
+  for (uint8_t d = 0; d < 4; d++)
+  {
+    for (long speed = 6000; speed <= 20000; speed += 2000)
+    {
+      // Slightly off-axis strokes: 1/4 of the speed on the other axis
+      Trajectory t = {2000 - (int)(dirX[d] * 1700), 2000 - (int)(dirY[d] * 1700),
+                      dirX[d] * speed + dirY[d] * speed / 4,
+                      dirY[d] * speed + dirX[d] * speed / 4, 300, 40};
+      Result r = run(swipe, t, start);
+      start += 1000;
+      total++;
+      if (r.gesture == expected[d] && r.detections == 1)
+        { correct++; }
+      if (r.latency > worst)
+        { worst = r.latency; }
+    }
+  }
+  assertEqual(total, correct);
+  assertLessOrEqual(worst, 150UL);          // Slowest stroke still beats the exit delay
+}
+
+unittest(rejects_slow_and_diagonal_motion)
+{
+  PAJ7620_SwipeRecognizer swipe;
+  Trajectory drift = {300, 2000, 1500, 0, 2000, 20};   // Far, but slow
+  Trajectory hover = {2000, 2000, 0, 0, 1000, 60};     // Hand held still
+  Trajectory diagonal = {300, 300, 10000, 10000, 300, 0};
+  Trajectory shortHop = {2000, 2000, 12000, 0, 50, 0}; // Fast, only 600 counts
+  assertEqual(GES_NONE, run(swipe, drift).gesture);
+  assertEqual(GES_NONE, run(swipe, hover).gesture);
+  assertEqual(GES_NONE, run(swipe, diagonal).gesture);
+  assertEqual(GES_NONE, run(swipe, shortHop).gesture);
+}
+
+unittest(hover_then_swipe)
+{
+  PAJ7620_SwipeRecognizer swipe;
+  const unsigned long start = 1000;
+  for (unsigned long hover = 100; hover <= 350; hover += 50)
+  {
+    // Hand held still (with jitter), then a 12000/s stroke to the left
+    Gesture found = GES_NONE;
+    unsigned long foundAt = 0;
+    for (unsigned long ms = 0; ms <= hover + 200; ms += 10)
+    {
+      int noise = (int)(ms % 30) / 10 * 20 - 20;
+      int x = 3000 + noise;
+      if (ms > hover)
+        { x -= (int)(12000L * (long)(ms - hover) / 1000); }
+      Gesture g = swipe.update(true, x, 2000, start + ms);
+      if (g != GES_NONE && found == GES_NONE)
+        { found = g; foundAt = ms; }
+    }
+    swipe.update(false, 0, 0, start + hover + 210);
+
+    assertEqual(GES_LEFT, found);
+    // 800 counts takes about 70ms of stroke, hover time is not averaged in
+    assertLessOrEqual(foundAt - hover, 100UL);
+  }
+}
+
+unittest(custom_thresholds)
+{
+  PAJ7620_SwipeRecognizer swipe(400, 2000, 400);
+  Trajectory drift = {300, 2000, 2500, 0, 400, 0};
+  Result r = run(swipe, drift);
+  assertEqual(GES_RIGHT, r.gesture);
+  assertEqual(160UL, r.latency);            // 400 counts at 2500/s
+}
+
+unittest(reset_clears_last_swipe)
+{
+  PAJ7620_SwipeRecognizer swipe;
+  Trajectory right = {300, 2000, 12000, 0, 300, 0};
+  run(swipe, right);
+  swipe.reset();
+  SwipeInfo info;
+  swipe.getLastSwipe(info);
+  assertEqual(GES_NONE, info.gesture);
+  assertEqual(0, info.speed);
+}
+
+unittest_main()
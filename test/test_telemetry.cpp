@@ -0,0 +1,67 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+std::deque<uint8_t> *miso;
+std::deque<uint8_t> *mosi;
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  miso = Wire.getMiso(PAJ7620_I2C_BUS_ADDR);
+  miso->push_back(PAJ7620_PART_ID_LSB);
+  miso->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensor->begin();
+  mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  mosi->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  sensor = NULL;
+}
+
+unittest(telemetry_is_one_burst_with_every_field_unpacked)
+{
+  // 0xAC..0xB7, reserved high bits set to show they are masked off
+  const uint8_t block[PAJ7620_OBJECT_BLOCK_SIZE] = {
+    0x34, 0xF2,           // Center X low, high [4:0]
+    0x78, 0xE5,           // Center Y low, high [4:0]
+    0x9A,                 // Brightness
+    0xBC, 0xFD,           // Size low, high [3:0]
+    0x11, 0x22, 0x33, 0x44,
+    0xF6                  // Wave count [3:0]
+  };
+  for (int i = 0; i < PAJ7620_OBJECT_BLOCK_SIZE; i++)
+    { miso->push_back(block[i]); }
+
+  ObjectTelemetry telemetry;
+  assertEqual(1, sensor->readObjectTelemetry(telemetry));
+  assertEqual(1, mosi->size());
+  assertEqual(PAJ7620_ADDR_OBJECT_CENTER_X_LOW, mosi->at(0));
+  assertEqual(0, miso->size());
+
+  assertEqual(0x1234, telemetry.centerX);
+  assertEqual(0x0578, telemetry.centerY);
+  assertEqual(0x9A, telemetry.brightness);
+  assertEqual(0x0DBC, telemetry.size);
+  assertEqual(0x06, telemetry.waveCount);
+}
+
+unittest(largest_values_fit_their_fields)
+{
+  for (int i = 0; i < PAJ7620_OBJECT_BLOCK_SIZE; i++)
+    { miso->push_back(0xFF); }
+
+  ObjectTelemetry telemetry;
+  assertEqual(1, sensor->readObjectTelemetry(telemetry));
+  assertEqual(0x1FFF, telemetry.centerX);
+  assertEqual(0x1FFF, telemetry.centerY);
+  assertEqual(0xFF, telemetry.brightness);
+  assertEqual(0x0FFF, telemetry.size);
+  assertEqual(0x0F, telemetry.waveCount);
+}
+
+unittest_main()
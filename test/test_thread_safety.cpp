@@ -0,0 +1,70 @@
+#define PAJ7620_STD_LOCK
+#include <ArduinoUnitTests.h>
+#include <thread>
+#include "RevEng_PAJ7620.h"
+
+RevEng_PAJ7620 *sensor;
+PAJ7620_StdLock *sensorLock;
+
+unittest_setup()
+{
+  Wire.resetMocks();
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_LSB);
+  Wire.getMiso(PAJ7620_I2C_BUS_ADDR)->push_back(PAJ7620_PART_ID_MSB);
+  sensor = new RevEng_PAJ7620();
+  sensorLock = new PAJ7620_StdLock();
+  sensor->setLock(sensorLock);
+  sensor->setBurstUploads(PAJ7620_BURST_OFF);      // Single writes only
+  sensor->begin();
+  Wire.getMosi(PAJ7620_I2C_BUS_ADDR)->clear();
+}
+
+unittest_teardown()
+{
+  delete sensor;
+  delete sensorLock;
+  sensor = NULL;
+}
+
+// Two threads hammer mode changes and enable/disable, which all switch banks.
+// Uploads are pinned to single writes, so every write below is a two byte
+// (address, value) pair and the bus log can be replayed to check each register landed in the bank it was meant for.
+unittest(interleaved_bank_switches_stay_consistent)
+{
+  const int loops = 200;
+
+  std::thread modeThread([&]() {
+    for (int i = 0; i < loops; i++)
+      { sensor->setCursorMode(); }
+  });
+  std::thread enableThread([&]() {
+    for (int i = 0; i < loops; i++)
+      { sensor->disable(); sensor->enable(); }
+  });
+  modeThread.join();
+  enableThread.join();
+
+  std::deque<uint8_t> *mosi = Wire.getMosi(PAJ7620_I2C_BUS_ADDR);
+  assertEqual(0, mosi->size() % 2);
+
+  int bank = 0;
+  int misplaced = 0;
+  int enableWrites = 0;
+  for (size_t i = 0; i + 1 < mosi->size(); i += 2)
+  {
+    uint8_t address = mosi->at(i);
+    if (address == PAJ7620_REGISTER_BANK_SEL)
+      { bank = mosi->at(i + 1); }
+    else if (address == PAJ7620_ADDR_OPERATION_ENABLE)
+      { enableWrites++; if (bank != 1) { misplaced++; } }
+    else if (address == 0x74 && bank != 1)          // Cursor mode select
+      { misplaced++; }
+    else if (address == PAJ7620_ADDR_GES_PS_DET_MASK_0 && bank != 0)
+      { misplaced++; }
+  }
+  assertEqual(loops * 2, enableWrites);
+  assertEqual(0, misplaced);
+  assertEqual(0, bank);                             // Always parked in bank 0
+}
+
+unittest_main()
@@ -0,0 +1,60 @@
+#include <ArduinoUnitTests.h>
+#include "RevEng_PAJ7620_WaveAccumulator.h"
+
+unittest(first_reading_is_baseline)
+{
+  PAJ7620_WaveAccumulator waves;
+  assertEqual(0, waves.update(7, 0));
+  assertEqual(2, waves.update(9, 100));
+}
+
+unittest(wrap_is_counted)
+{
+  PAJ7620_WaveAccumulator waves;
+  waves.update(14, 0);
+  assertEqual(4, waves.update(2, 100));     // 15, 0, 1, 2
+  assertEqual(19, waves.update(1, 200));    // Full 15 more
+  assertEqual(19, waves.update(1, 300));    // No change
+}
+
+unittest(total_passes_sixteen_bits)
+{
+  PAJ7620_WaveAccumulator waves;
+  uint8_t raw = 0;
+  waves.update(raw, 0);
+  for (unsigned long i = 1; i <= 5000; i++)
+  {
+    raw = (raw + 15) & 0x0F;
+    waves.update(raw, i * 100);
+  }
+  assertEqual(75000UL, waves.total());
+}
+
+unittest(rate_over_sliding_window)
+{
+  PAJ7620_WaveAccumulator waves(10000);
+  uint8_t raw = 0;
+  // One wave per second for 30s, then nothing
+  for (unsigned long t = 0; t <= 30000; t += 1000)
+    { waves.update(raw++, t); }
+  assertEqual(60, waves.wavesPerMinute());
+
+  // Polled every 1s the 16 remembered polls cover the 10s window
+  for (unsigned long t = 31000; t <= 45000; t += 1000)
+    { waves.update(raw - 1, t); }
+  assertEqual(0, waves.wavesPerMinute());
+}
+
+unittest(poll_interval_keeps_up)
+{
+  // 60 waves/min: 15 waves take 15s, poll twice as often
+  assertEqual(7500, PAJ7620_WaveAccumulator::recommendedPollInterval(60));
+  assertEqual(3750, PAJ7620_WaveAccumulator::recommendedPollInterval(120));
+
+  PAJ7620_WaveAccumulator waves;
+  waves.update(0, 0);
+  waves.update(2, 1000);                    // 120 waves/min
+  assertEqual(3750, waves.recommendedPollInterval());
+}
+
+unittest_main()